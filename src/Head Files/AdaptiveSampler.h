@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QtGlobal>
+
+// 长截图自适应采样间隔
+// - 相邻帧滚动量大（超过半帧）时间隔减半，滚得很慢时略微放宽
+// - 画面静止时按指数退避，最长到 maxMs
+// - 检测到滚轮等外部活动时立即回到最短间隔
+// 同时用指数滑动平均统计实际抓帧速率，供预览面板显示
+class AdaptiveSampler
+{
+public:
+    AdaptiveSampler(int minMs = 40, int maxMs = 800, int initialMs = 200);
+
+    void reset();
+
+    int interval() const { return interval_; }
+
+    // fraction：本帧滚动量占帧高的比例
+    void onMotion(double fraction);
+    void onStatic();
+    void onActivity();
+
+    // 每次真正抓到一帧时调用（单调时钟毫秒）
+    void onFrameGrabbed(qint64 nowMs);
+    // 实际抓帧速率（帧/秒），样本不足时为 0
+    double rate() const;
+
+private:
+    void setInterval(double ms);
+
+    int minMs_;
+    int maxMs_;
+    int initialMs_;
+    int interval_;
+    qint64 lastGrabMs_ = -1;
+    double avgGrabGapMs_ = 0;   // 抓帧间隔的滑动平均
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QImage>
+#include <QRect>
+
+// 模糊引擎：三趟可分离盒式模糊逼近高斯，直接在 32 位图像内存上处理
+// - 水平 / 垂直两个方向都按扫描线顺序访问，内层循环是连续的整数累加，便于编译器向量化
+// - 区域较大时按行带 / 列带拆分给 QThreadPool 并行
+// - 边界外按边缘像素延伸，结果只写回 area 内
+class BlurEngine
+{
+public:
+    // radius：模糊半径（像素，约等于 2 倍标准差）
+    // strength：0-100，模糊结果与原图的混合比例，100 为完全模糊
+    static void blur(QImage& image, const QRect& area, int radius, int strength = 100);
+
+    // 每趟盒式模糊使用的半径（三趟叠加后近似标准差为 radius / 2 的高斯）
+    static int boxRadiusFor(int radius);
+};
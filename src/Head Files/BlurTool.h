@@ -6,23 +6,29 @@
 
 /**
  * @brief ˹ģЧ
- * @details ṩ͸ȿɵڵģЧ
+ * @details ṩ뾶ǿȿɵڵģЧʵʼ BlurEngine 
  */
 class BlurTool : public QObject {
     Q_OBJECT
 public:
     explicit BlurTool(QObject* parent = nullptr);
 
-    static void applyEffect(QPixmap& pixmap, const QRect& area, int opacity);
+    // radiusģ뾶أopacityģǿȰٷֱȣ0 Ϊԭͼ100 Ϊȫģ
+    static void applyEffect(QPixmap& pixmap, const QRect& area, int radius, int opacity);
 
     QWidget* createSettingsWidget(QWidget* parent = nullptr);
 
     int opacity() const { return m_opacity; }
     void setOpacity(int opacity);
 
+    int radius() const { return m_radius; }
+    void setRadius(int radius);
+
 signals:
     void opacityChanged(int opacity);
+    void radiusChanged(int radius);
 
 private:
     int m_opacity = 50; // ͸ȰٷֱȣΧ0-100
+    int m_radius = 15;  // ģ뾶Χ1-50
 };
\ No newline at end of file
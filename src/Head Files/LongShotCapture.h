@@ -7,11 +7,16 @@
 #include <QPixmap>
 #include <QPointer>
 #include <QTimer>
+#include <QThread>
+#include <QElapsedTimer>
+#include "LongShotWorker.h"
+#include "AdaptiveSampler.h"
 
 class QWidget;
 class QPainter;
 class QKeyEvent;
 class QWheelEvent;
+class QScreen;
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -22,12 +27,16 @@ class LongShotCapture : public QObject
     Q_OBJECT
 public:
     explicit LongShotCapture(QObject* parent = nullptr);
+    ~LongShotCapture() override;
 
     void start(const QRect& selectionInOverlay, QWidget* overlayWidget);
     void stop();
 
     bool isActive() const { return active_; }
 
+    // ƴӽڴռõֽ䵽ʱļ
+    void setMemoryBudget(qint64 bytes);
+
     void paintPreview(QPainter& painter, const QRect& widgetRect);
 
     bool handleKeyPress(QKeyEvent* event);
@@ -40,12 +49,42 @@ public:
 
 private slots:
     void onTick();
+    void onPreviewBand(const QImage& band, int generation);
+    void onFrameProcessed(int generation, bool changed, double motion, bool overlapLost);
+    // Ŀ괰йֵȲϻص̲
+    void onScrollActivity();
+    void onFullFrameRequested(int generation);
+    void onStickyRegions(int generation, double headerFraction, double footerFraction);
+    void onPanoramaStarted(int generation);
+    void onPanoramaPreview(const QImage& thumbnail, int generation);
 
 private:
     bool active_ = false;
     QRect captureRectGlobal_;
-    QVector<QPixmap> segments_;
-    QPixmap previewPixmap_;
+    // ̨ˮߣGUI ֻ߳ץͼ๤ worker_
+    QThread workerThread_;
+    LongShotWorker* worker_ = nullptr;
+    int generation_ = 0;
+    int pendingFrames_ = 0;         // Ͷݵ worker û֡
+    int grabbedFrames_ = 0;         // γͼץ֡
+    // Ӧʱӿ졢ֹʱ˱
+    AdaptiveSampler sampler_;
+    QElapsedTimer clock_;
+    int overlapWarnings_ = 0;       // Ҳص©ģĴ
+    // ֶץȡνӿɿʱֻץ̽͵ײݣ˵֡
+    bool needFullFrame_ = true;
+    int lastMotionRows_ = 0;        // һ֡Ҫץݣ
+    int headerRows_ = 0;            //  / ߼أֶץȡʱ̽ / ײҪ
+    int footerRows_ = 0;
+    // Ԥworker õĹ̶GUI ֻ߳ƴʾ
+    QVector<QImage> previewStrip_;
+    int previewStripHeight_ = 0;
+    // ȫģʽ / бƽʱ worker Ϊϡ軭ƴӣԤŻͼ
+    bool panorama_ = false;
+    QImage panoramaPreview_;
+    // ҲĻ棬ֻ׷ݻߴ仯ʱػ
+    QPixmap panelCache_;
+    bool panelDirty_ = true;
     QTimer timer_;
     QPointer<QWidget> overlay_;
 
@@ -55,7 +94,14 @@ private:
     HWND  targetWindow_ = nullptr;  // ץͼʵʴ
 #endif
 
-    void updatePreview();
-    bool isFrameDifferent(const QPixmap& a, const QPixmap& b);
+    void rebuildPanelCache(const QSize& size);
+    // ץȡȫ rect ΧĿ괰ʱӴץ
+    QPixmap grabGlobal(QScreen* screen, const QRect& rect) const;
+    //  worker Ͷݵ֡β֮ܶȡƴӽ
+    void drainWorker();
+    QImage composeResult() const;
+    // ƴӽд pathPNG ʽ룬ʽڳߴʱͼ棻
+    // ̫ʱĴΪͬ PNGļʵ·д savedPathʧԭд error
+    bool exportTo(const QString& path, QString* savedPath, QString* error) const;
     void finishAndExport();
 };
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QImage>
+#include <QObject>
+#include "PanoramaCanvas.h"
+#include "ScrollStitcher.h"
+#include "SegmentStore.h"
+
+// 长截图后台流水线：运行在独立线程里，GUI 线程只负责定时抓图
+// - 指纹计算、变化检测、滚动量估计、分段存储、预览缩放都在这里完成
+// - 每处理完一帧发出 frameProcessed（附带滚动量等统计），GUI 线程据此限制排队的帧数、调整采样间隔
+// - 只有新内容需要显示时才把缩好的预览条带发回 GUI 线程
+// - 拼接器切换到全景模式后，各帧贴到稀疏画布 panorama_ 上，预览改为整张画布的缩略图
+// 每次 start 对应一个 generation，旧 generation 的结果由 GUI 线程丢弃
+class LongShotWorker : public QObject
+{
+    Q_OBJECT
+public:
+    // 预览条带宽度（像素）
+    static constexpr int kPreviewWidth = 480;
+
+    explicit LongShotWorker(QObject* parent = nullptr);
+
+    // 只能在流水线空闲时（所有帧处理完之后）从其它线程读取
+    const SegmentStore& segments() const { return segments_; }
+    const PanoramaCanvas& panorama() const { return panorama_; }
+    bool isPanorama() const { return !panorama_.isEmpty(); }
+
+public slots:
+    void reset(int generation);
+    void setMemoryBudget(qint64 bytes);
+    void processFrame(const QImage& frame, int generation);
+    // 分段抓取：probe 为选区顶部的探针条，tail 为选区底部的若干行
+    void processBand(const QImage& probe, const QImage& tail, int generation);
+    // 结束拼接：把拼接器里还没输出的部分（第一帧 / 吸底区域）追加到结果
+    void finish(int generation);
+
+signals:
+    // changed：内容是否变化；motion：滚动量占帧高的比例；overlapLost：找不到与上一帧的重叠（可能漏拍）
+    void frameProcessed(int generation, bool changed, double motion, bool overlapLost);
+    void previewBandReady(const QImage& band, int generation);
+    // 分段抓取衔接不上，下一次需要抓整帧
+    void fullFrameRequested(int generation);
+    // 识别出吸顶 / 吸底区域，参数为各自占帧高的比例
+    void stickyRegionsChanged(int generation, double headerFraction, double footerFraction);
+    // 检测到横向 / 斜向平移，本次截图改为全景模式（之后只处理整帧）
+    void panoramaStarted(int generation);
+    void panoramaPreviewReady(const QImage& thumbnail, int generation);
+
+private:
+    void handleResult(const ScrollStitcher::Result& stitched, const QSize& frameSize, int generation);
+    void appendBand(const QImage& band, int generation);
+
+    ScrollStitcher stitcher_;
+    SegmentStore segments_;         // 拼接结果：第一帧 + 之后每帧新露出的部分 + 吸底区域
+    PanoramaCanvas panorama_;       // 全景模式的拼接结果
+    int generation_ = 0;
+};
@@ -18,6 +18,8 @@ private slots:
 
 private:
     void createTrayIcon();      // ͼͲ˵
+    void startOcrWarmUp();      // ̨Ԥ OCR ģ
+    void setupOcrCache();       // OCR 棨ѡ̣
 
     QSystemTrayIcon* trayIcon_ = nullptr;
     QMenu* trayMenu_ = nullptr;
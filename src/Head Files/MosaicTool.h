@@ -14,6 +14,8 @@ public:
     explicit MosaicTool(QObject* parent = nullptr);
 
     static void applyEffect(QPixmap& pixmap, const QRect& area, int blockSize);
+    // ֱ 32 λͼڴԭشʽת ARGB32_Premultiplied
+    static void applyEffect(QImage& image, const QRect& area, int blockSize);
 
     QWidget* createSettingsWidget(QWidget* parent = nullptr);
 
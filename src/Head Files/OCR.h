@@ -3,40 +3,61 @@
 #include <QObject>
 #include <QImage>
 #include <QString>
+#include <functional>
 #include <memory>
 
-// 前置声明，避免在头文件中包含 Paddle/OpenCV 头文件
-namespace cv {
-    class Mat;
-}
+#include "OcrProfile.h"
+#include "OcrResult.h"
 
+// 前置声明，避免在头文件中包含 Paddle/OpenCV 头文件
 class PaddleOcrInternal;
 
 class OcrEngine : public QObject {
     Q_OBJECT
 
 public:
+    // 一次识别经过的阶段，依次为（首次识别时的）加载模型、检测、方向分类、识别、低置信度行重识别
+    enum class Stage {
+        kLoadModels,
+        kDetect,
+        kClassify,
+        kRecognize,
+        kRefine,
+    };
+    // 每个阶段开始时调用，运行在调用 recognize() 的线程里；被跳过的阶段不会回调
+    using StageCallback = std::function<void(Stage stage)>;
+
     explicit OcrEngine(QObject* parent = nullptr);
     ~OcrEngine();
 
-    // 单例访问接口
-    static OcrEngine& instance();
-
     // 初始化 OCR 引擎
-    // modelDir: 包含 det, rec, cls 模型文件的目录
+    // modelDir: 包含 det, rec, cls 模型文件的目录（各档位的轻量 / 服务端模型也放在这里）
     bool init(const QString& modelDir);
 
-    // 提供的公共函数，传入图片进行识别，返回识别结果
-    QString detectText(const QImage& image);
+    // 选择速度 / 精度档位，必须在 init（或第一次识别触发的懒加载）之前设置
+    void setProfile(const OcrProfile& profile);
+    const OcrProfile& profile() const { return profile_; }
+
+    // 传入图片进行识别，返回每一行的检测框、文本、置信度以及各阶段耗时
+    // 未初始化时按 <exe 目录>/models 懒加载模型；输入经 OcrImageBridge 转成 BGR，
+    // BGR888 直接包装，其余格式只转换一次到复用缓冲区
+    // useCache: 先按像素内容查 OcrResultCache，命中直接返回；识别成功后写回缓存
+    OcrResult recognize(const QImage& image, bool useCache = true, const StageCallback& onStage = StageCallback());
+
+    // 纯文本接口：recognize() 的结果按行拼接
+    QString detectText(const QImage& image, bool useCache = true);
+
+    // 低置信度行的二次识别：置信度低于 threshold 的行把原图裁剪放大 2-3 倍后只重跑识别阶段，
+    // 分数更高才替换；检测不重做。threshold <= 0 关闭
+    void setRefineThreshold(float threshold) { refine_threshold_ = threshold; }
 
     // 释放 OCR 引擎资源
     void release();
 
 private:
-    // 内部处理函数：QImage 转 cv::Mat
-    static cv::Mat QImageToCvMat(const QImage& image);
-
     // 使用 Pimpl 模式隐藏 PaddleOCR 具体实现细节
     std::unique_ptr<PaddleOcrInternal> internal_;
     bool is_initialized_ = false;
+    OcrProfile profile_ = OcrProfile::balanced();
+    float refine_threshold_ = profile_.refineThreshold;
 };
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QImage>
+#include <opencv2/core.hpp>
+
+// QImage -> cv::Mat（PaddleOCR 需要的 BGR / CV_8UC3）桥接
+// - 先把 QImage 的扫描行直接包成 cv::Mat 头（不拷贝像素）
+// - 格式已经是 BGR888 时直接返回这个头，零拷贝
+// - 其余格式只做一次 cvtColor，写进复用的缓冲区，不再额外 clone
+// 一个实例同一时刻只能给一个线程用（和它所属的 OcrEngine 一样）
+class OcrImageBridge
+{
+public:
+    struct Stats {
+        quint64 zeroCopy = 0;      // 直接包装、没有任何像素拷贝的次数
+        quint64 converted = 0;     // 包装后一次 cvtColor 到缓冲区的次数
+        quint64 qtConversions = 0; // 不支持的格式先经 QImage::convertToFormat 的次数（多一次拷贝）
+        quint64 bufferReallocs = 0; // 缓冲区重新分配的次数
+    };
+
+    // 返回的 Mat 可能直接引用 image 的像素，也可能引用内部缓冲区：
+    // 都只在 image 存活且下一次 toBgr 之前有效
+    cv::Mat toBgr(const QImage& image);
+
+    // 只包装不转换：返回与 image 共享像素的 Mat 头，格式不支持时返回空 Mat
+    static cv::Mat wrap(const QImage& image);
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    cv::Mat buffer_;       // 复用的 BGR 缓冲，尺寸不变时不重新分配
+    QImage converted_;     // 不支持的格式转换后的临时图，保证 wrap 出的 Mat 有效
+    Stats stats_;
+};
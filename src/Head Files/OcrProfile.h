@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+// OCR 速度 / 精度档位：决定加载哪套模型、是否跑方向分类、推理线程数和输入尺寸上限
+// - fast：轻量模型（models/det_lite、rec_lite，不存在时回退到默认模型），跳过方向分类，
+//   检测输入长边限制在 736，不做低置信度二次识别；适合随手复制一小段文字
+// - balanced：默认模型，开方向分类，检测长边 960（引入档位之前的设置），推理线程取核数一半
+// - accurate：服务端模型（models/det_server、rec_server，不存在时回退），开方向分类，
+//   检测输入长边放宽到 1920，二次识别阈值更高；适合整页文档
+// 每个档位的模型在第一次用到时才加载；cpuThreads 是单个实例的上限，
+// 多个实例并行识别切片时由 sizedForPool 按实例数均分核数，避免线程数超过核数
+struct OcrProfile {
+    QString name;
+    QString detModel = "det";       // 相对模型根目录的子目录
+    QString recModel = "rec";
+    QString fallbackDet = "det";    // detModel / recModel 不存在时使用
+    QString fallbackRec = "rec";
+    bool useCls = true;             // 方向分类（cls 模型存在时才生效）
+    int cpuThreads = 4;
+    int limitSideLen = 960;         // 检测阶段输入长边上限（limit_type = max）
+    int recBatch = 6;
+    float refineThreshold = 0.85f;  // 低置信度二次识别阈值，<= 0 关闭
+
+    static OcrProfile fast();
+    static OcrProfile balanced();
+    static OcrProfile accurate();
+
+    // 同时有 engines 个实例在跑时每个实例的配置：推理线程不超过 核数 / engines
+    OcrProfile sizedForPool(int engines) const;
+
+    static QString defaultName() { return "balanced"; }
+    static QStringList names();
+    // 未知名字返回 balanced
+    static OcrProfile byName(const QString& name);
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QPolygon>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 一行识别结果：检测框（原图坐标，顺时针四点）、文本和置信度
+struct OcrLine {
+    QPolygon polygon;
+    QString text;
+    float confidence = -1.0f;   // 识别置信度 0-1，未识别为 -1
+
+    QRect boundingRect() const { return polygon.boundingRect(); }
+};
+
+// 一次识别的结构化结果，lines 按阅读顺序（从上到下、同一行从左到右）排列
+struct OcrResult {
+    QVector<OcrLine> lines;
+    QSize imageSize;
+
+    // 各阶段耗时；切片识别时是各片之和，totalMs 是整次识别的墙钟时间
+    qint64 detMs = 0;
+    qint64 clsMs = 0;
+    qint64 recMs = 0;
+    qint64 refineMs = 0;     // 低置信度行放大后重新识别的耗时
+    int refinedLines = 0;    // 重新识别后被采用的行数
+    qint64 totalMs = 0;
+    bool fromCache = false;
+
+    bool isEmpty() const { return lines.isEmpty(); }
+
+    // 纯文本形式：一行一个检测框
+    QString text() const
+    {
+        QStringList out;
+        out.reserve(lines.size());
+        for (const OcrLine& line : lines) {
+            out << line.text;
+        }
+        return out.join('\n');
+    }
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "OcrResult.h"
+
+// OCR 结果的 LRU 缓存，以输入像素的内容哈希为 key
+// - 同一张图（Pin 之后再 OCR、截图里 OCR 完再在 Pin 窗口 OCR）直接返回上次的结构化结果
+// - 同时受条目数和结果字节数（文本 + 检测框）约束，超出时淘汰最久未用的
+// - 可选落盘：设置存储文件后启动时读回；写入只标记为脏，停顿一会儿后在线程池里合并保存一次，
+//   写文件时不持有缓存的锁，程序退出前补写还没保存的改动
+// 所有 OcrEngine 实例共用一个缓存，接口线程安全
+class OcrResultCache
+{
+public:
+    static OcrResultCache& instance();
+
+    // 内容哈希：逐行哈希像素（跳过行尾填充），再混入尺寸和格式；128 位，十六进制
+    static QByteArray keyFor(const QImage& image);
+    // 带档位的 key：不同档位的结果不能互相顶替
+    static QByteArray keyFor(const QImage& image, const QString& profile);
+
+    bool lookup(const QByteArray& key, OcrResult* result);
+    void insert(const QByteArray& key, const OcrResult& result);
+    void clear();
+
+    void setLimits(int maxEntries, qint64 maxBytes);
+    // 传空串关闭落盘；打开时会先读回已有内容
+    void setStorageFile(const QString& path);
+    // 立即把未保存的改动写到存储文件（任意线程）；没有改动时什么也不做
+    void flush();
+
+    int count() const;
+    qint64 bytes() const;
+
+private:
+    OcrResultCache() = default;
+
+    struct Entry {
+        OcrResult result;
+        qint64 bytes = 0;
+    };
+
+    void evictLocked();
+    void loadLocked();
+    void scheduleSaveLocked();
+
+    // 加锁顺序：save_mutex_ 在前，mutex_ 在后
+    mutable QMutex mutex_;
+    QMutex save_mutex_;         // 串行化写文件，不阻塞 lookup / insert
+    QHash<QByteArray, Entry> entries_;
+    QList<QByteArray> order_;   // 最久未用的在前
+    qint64 bytes_ = 0;
+    int max_entries_ = 128;
+    qint64 max_bytes_ = 4ll * 1024 * 1024;
+    QString storage_file_;
+    bool dirty_ = false;            // 有还没写到文件的改动
+    bool save_scheduled_ = false;   // 已经排了一次延迟保存
+    bool quit_hooked_ = false;      // 已经连上 aboutToQuit
+};
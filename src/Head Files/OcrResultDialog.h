@@ -4,7 +4,10 @@
 #include <QPixmap>
 #include <QScrollArea>
 
-class QLabel;
+#include "OcrResult.h"
+
+class OcrImageView;
+class QProgressBar;
 class QTextEdit;
 class QPushButton;
 
@@ -18,9 +21,16 @@ public:
     // 设置识别结果文本
     void SetResultText(const QString& text);
 
+    // 设置结构化识别结果：文本一行对应一个检测框，图片上画出所有框；
+    // 在文本里选中的行会在图片上高亮，点击图片上的框会选中对应的文本行
+    void SetResult(const OcrResult& result);
+
     // 追加识别结果文本
     void AppendResultText(const QString& text);
 
+    // 识别进度（percent: 0-100），SetResultText 之后进度条自动隐藏
+    void SetProgress(int percent, const QString& stage);
+
 protected:
     void resizeEvent(QResizeEvent* event) override;
     void showEvent(QShowEvent* event) override;
@@ -28,21 +38,25 @@ protected:
 
 private slots:
     void OnCopy();
+    void OnTextSelectionChanged();
 
 private:
     void SetupUi();
     void UpdateImageScale();
+    void SelectLine(int index);
 
     QPixmap pixmap_;
     QString text_;
+    OcrResult result_;   // 文本区第 i 行对应 result_.lines[i]
 
-    QLabel* image_label_ = nullptr;
+    OcrImageView* image_view_ = nullptr;
     QScrollArea* scroll_area_ = nullptr;
     QTextEdit* text_edit_ = nullptr;
 
     // UI Components
     QPushButton* btn_copy_ = nullptr;
     QPushButton* btn_close_ = nullptr;
+    QProgressBar* progress_bar_ = nullptr;
 
     // Zoom state
     double scale_factor_ = 1.0;
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "OCR.h"
+#include "OcrProfile.h"
+#include "OcrResult.h"
+
+// 一次异步识别请求的句柄，所有信号都在 GUI 线程发出
+// - cancel() 或句柄被销毁（例如随 parent 对话框一起关闭）即视为取消：
+//   还在排队的请求直接跳过，正在推理的请求等这一次推理结束后丢弃结果
+// - resultReady / failed 二者只发其一，之后句柄会自动 deleteLater
+class OcrTask : public QObject {
+    Q_OBJECT
+
+public:
+    ~OcrTask() override;
+
+    void cancel();
+    bool isCanceled() const;
+
+signals:
+    // percent: 0-100；stage: 当前阶段的简短说明
+    void progress(int percent, const QString& stage);
+    // 结构化结果（检测框、置信度、各阶段耗时）；需要纯文本时用 result.text()
+    void resultReady(const OcrResult& result);
+    void failed(const QString& error);
+
+private:
+    friend class OcrService;
+    explicit OcrTask(QObject* parent);
+
+    // worker 线程只持有这个标志，不碰 OcrTask 本身
+    std::shared_ptr<std::atomic_bool> canceled_;
+};
+
+// 异步 OCR 服务：OcrEngine 的推理全部放到专用 worker 线程里按提交顺序执行，
+// GUI 线程只负责提交请求和接收结果，从不等待推理
+// - OcrEngine 只代表一套加载好的模型，保持同步接口，同一时刻只给一个线程用；
+//   排队、实例池、取消以及把阶段进度 / 结果送回 GUI 线程都属于调度，放在这一层，
+//   预热、切片并行和离线工具都直接复用同一个同步引擎
+// - 单张图按引擎回报的阶段（加载模型 / 检测 / 方向分类 / 识别 / 重识别）推进进度
+// - 长截图 / 整屏这类大图先由 OcrTiler 切片，各片在识别实例池里并行推理后再合并
+// - 每次识别可以指定档位（OcrProfile）；各档位的实例按需创建，但共用同一个实例上限，
+//   上限用满时先释放别的档位的空闲实例，总的模型内存不会随档位数增长
+class OcrService : public QObject {
+    Q_OBJECT
+
+public:
+    // 预热耗时：cold 是启动后第一次推理（包含懒加载模型），warm 是模型就绪后的同图推理
+    struct WarmUpStats {
+        bool done = false;
+        bool ok = false;
+        qint64 coldMs = -1;
+        qint64 warmMs = -1;
+    };
+
+    static OcrService& instance();
+    ~OcrService() override;
+
+    // 提交一次识别，返回的句柄以 owner 为 parent；owner 销毁时请求自动取消
+    // profile 为空时使用默认档位
+    OcrTask* recognize(const QImage& image, QObject* owner, const QString& profile = QString());
+
+    // 默认档位（fast / balanced / accurate），未知名字按 balanced 处理
+    void setDefaultProfile(const QString& name);
+    QString defaultProfile() const { return default_profile_.name; }
+
+    // 在 worker 线程以低优先级加载模型并对一张合成图做两次推理，
+    // 让第一次真正的识别不再等模型加载；重复调用只执行一次
+    void warmUp();
+    WarmUpStats warmUpStats() const { return warm_up_stats_; }
+
+    // 并行识别的实例上限（每个实例各自持有一套模型，约几百 MB），默认按核数取 1-4；
+    // 之后创建的实例推理线程数按 核数 / 上限 分配（OcrProfile::sizedForPool）
+    void setMaxEngines(int count);
+
+signals:
+    void warmUpFinished(const OcrService::WarmUpStats& stats);
+
+private:
+    explicit OcrService(QObject* parent = nullptr);
+
+    // 以下在 worker 线程执行
+    void run(quint64 id, const QImage& image, const OcrProfile& profile,
+        const std::shared_ptr<std::atomic_bool>& canceled);
+    void runWarmUp(const QImage& sample, const OcrProfile& profile);
+    // 切片并行识别，error 只在所有切片都失败时填写；整图结果按整图的 key 缓存，切片不单独缓存
+    OcrResult recognizeTiled(quint64 id, const QImage& image, const OcrProfile& profile,
+        const std::shared_ptr<std::atomic_bool>& canceled, QString* error);
+    // 单张图在一个池内实例上识别，异常转成 error；useCache = false 时绕过结果缓存（预热和切片用）
+    OcrResult recognizeOne(const QImage& image, const OcrProfile& profile, QString* error, bool useCache = true,
+        const OcrEngine::StageCallback& onStage = OcrEngine::StageCallback());
+
+    // 识别实例池（任意线程）：每个实例同一时刻只给一个线程用，用完放回
+    OcrEngine* acquireEngine(const OcrProfile& profile);
+    void releaseEngine(OcrEngine* engine);
+    // 把进度 / 结果投递回 GUI 线程
+    void postProgress(quint64 id, int percent, const QString& stage);
+    // 单张图识别时把引擎的阶段边界换算成进度
+    void postStage(quint64 id, OcrEngine::Stage stage);
+    void postDone(quint64 id, const OcrResult& result, const QString& error);
+
+    // 以下在 GUI 线程执行
+    void onProgress(quint64 id, int percent, const QString& stage);
+    void onDone(quint64 id, const OcrResult& result, const QString& error);
+
+    QThread thread_;
+    QObject* context_ = nullptr;   // 住在 thread_ 里，用来把任务排进 worker 的事件队列
+    QHash<quint64, QPointer<OcrTask>> tasks_;
+    quint64 next_id_ = 1;
+
+    bool warm_up_requested_ = false;
+    WarmUpStats warm_up_stats_;   // GUI 线程
+    QSet<QString> ready_profiles_;   // worker 线程：模型已经跑通过一次的档位
+    OcrProfile default_profile_ = OcrProfile::balanced();   // GUI 线程
+
+    // 实例按档位各自懒加载，所有档位共用 max_engines_ 这一个上限
+    QMutex engines_mutex_;
+    QWaitCondition engine_released_;
+    QHash<QString, QVector<OcrEngine*>> idle_engines_;   // 档位名 -> 空闲实例
+    std::vector<std::unique_ptr<OcrEngine>> engines_;
+    int max_engines_ = 1;
+    QThreadPool tile_pool_;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+#include "OcrResult.h"
+
+// 大图 OCR 的切片规划与结果合并
+// - 只沿长边切：高图切成横条，宽图切成竖条，短边保持完整
+// - 切口优先落在“安静”的行 / 列上（整行颜色几乎一致，即文字行之间的空白），
+//   这样相邻切片不需要重叠，也不会把一行字切成两半
+// - 附近找不到空白时退回到固定重叠，合并时按检测框位置去掉重叠区被两边重复识别的行
+class OcrTiler
+{
+public:
+    struct Tile {
+        QRect rect;           // 在原图中的范围
+        int overlapBefore = 0;   // 与前一片重叠的像素数（切在空白处时为 0）
+    };
+
+    // 长边超过这个长度才切片
+    static bool needsTiling(const QSize& size);
+
+    // 规划切片；不需要切时返回覆盖整图的一片
+    static QVector<Tile> plan(const QImage& image);
+
+    // 合并各片的识别结果：检测框平移回原图坐标，重叠区里与前一片的框大面积重合的只留较完整的一个，
+    // 最后重新按阅读顺序排列；results 与 tiles 一一对应（失败的片传空结果）。
+    // 切片不走结果缓存，fromCache 由调用方（整图缓存命中时）设置
+    static OcrResult merge(const QVector<Tile>& tiles, const QVector<OcrResult>& results, const QSize& imageSize);
+
+private:
+    // 在 [from, to] 范围内找离 nominal 最近的空白带，返回切口位置，找不到返回 -1
+    static int findQuietCut(const QImage& image, bool alongHeight, int nominal, int from, int to);
+    static bool isQuietLine(const QImage& image, bool alongHeight, int index);
+};
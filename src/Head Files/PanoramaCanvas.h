@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+
+// 全景长截图的稀疏画布：按固定大小的 tile 存储，可以往任意方向（包括负坐标）生长
+// - 只为真正贴过图的 tile 分配内存，占用和覆盖面积成正比，而不是和外接矩形成正比
+// - 后贴的图覆盖先贴的图；没覆盖到的像素保持透明，导出时填成背景色
+// - 导出按 tile 行切条读取，配合流式编码整张图不需要出现在内存里
+class PanoramaCanvas
+{
+public:
+    static constexpr int kTileSize = 256;
+
+    void clear();
+
+    // 把 image 贴到画布坐标 pos（image 左上角）处
+    void paste(const QImage& image, const QPoint& pos);
+
+    bool isEmpty() const { return tiles_.isEmpty(); }
+    // 所有贴过的图的外接矩形（可能含负坐标）
+    QRect bounds() const { return bounds_; }
+    int tileCount() const { return tiles_.size(); }
+    qint64 memoryUsage() const { return qint64(tiles_.size()) * kTileSize * kTileSize * 4; }
+
+    // 拼出 area 范围的像素，没覆盖到的地方填 background
+    QImage copy(const QRect& area, QColor background = Qt::white) const;
+    // 整个画布缩小到 maxSize 以内（保持比例），没覆盖到的地方透明
+    // 缩略图是增量维护的：只重画上次调用之后新贴的区域；画布长大到当前比例放不下时
+    // 才换一个留有余量的比例整张重画，所以连续贴图时整张重画的次数是对数级的
+    QImage thumbnail(const QSize& maxSize);
+
+private:
+    static int tileIndex(int v);
+    static quint64 tileKey(int tx, int ty);
+
+    // 把 area（画布坐标）覆盖到的缩略图像素按当前比例从 tile 重画
+    void renderThumbnail(const QRect& area);
+
+    QHash<quint64, QImage> tiles_;   // key = (tx, ty)，tile 左上角为 (tx, ty) * kTileSize
+    QRect bounds_;
+
+    QImage thumb_;          // 缩略图缓存，覆盖 thumbRect_（缩放后的画布坐标，整数像素）
+    QRect thumbRect_;
+    double thumbScale_ = 0.0;
+    QSize thumbMaxSize_;
+    QRect thumbDirty_;      // 上次生成缩略图之后贴过图的区域（画布坐标）
+};
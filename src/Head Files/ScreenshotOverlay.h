@@ -20,6 +20,8 @@
 
 #include "LongShotCapture.h" 
 #include"ShapeDrawer.h"
+#include "TiledCanvas.h"
+#include "SpatialGrid.h"
 #ifdef Q_OS_WIN
 #include "uiinspector.h"
 #endif
@@ -34,6 +36,9 @@ public:
     // 设置整屏截图作为背景
     void SetBackground(const QPixmap& pixmap);
 
+    // 撤销历史的内存上限（字节），超出后丢弃最早的记录
+    void SetUndoMemoryBudget(qint64 bytes);
+
 signals:
     // 目前我们主要是直接复制到剪贴板，
     // 这个信号可以留作以后需要把结果传回 MainWindow 使用。
@@ -86,12 +91,22 @@ private:
         QColor color = QColor(255, 80, 80);
         int stroke_width = 4;
         int mosaic_level = 10;      // mosaic 参数
-        int blur_opacity = 50;      // blur 参数
+        int blur_opacity = 50;      // blur 参数：强度
+        int blur_radius = 15;       // blur 参数：半径
+        quint64 id = 0;             // 提交时分配的稳定编号（空间索引的 key，撤销 / 重做后不变）
     };
 
-    struct UndoState {
-        QImage image;
-        QVector<DrawItem> items;
+    // 撤销记录：只记录对 items_ 的增 / 删，不保存像素；
+    // 撤销 / 重做时由 canvas_ 按受影响对象的范围局部重建
+    struct EditCommand {
+        enum class Kind {
+            kAdd,
+            kRemove,
+        } kind = Kind::kAdd;
+
+        QVector<int> indices;        // 受影响对象在 items_ 中的下标（升序）
+        QVector<DrawItem> before;    // kRemove：被删除的对象
+        QVector<DrawItem> after;     // kAdd：新增的对象
     };
 
     bool InsideSelection(const QPoint& pos) const;
@@ -114,15 +129,39 @@ private:
     // 撤销 / 重做
     void Undo();
     void Redo();
+    void PushCommand(EditCommand cmd);
+    // 超出内存上限时丢弃最早的 undo 记录，至少保留最近一条
+    void TrimUndoStack();
+    // forward = true 重做该命令，false 撤销该命令
+    void ApplyCommand(const EditCommand& cmd, bool forward);
+    static qint64 CommandBytes(const EditCommand& cmd);
 
     QRect ComputeZoomSourceRect(const QSize& content_size) const;
     void showToolPopup(QWidget* popup);
 
-    // 新增：从 base + items 合成 canvas（preview 可选）
-    void RepaintCanvasFromItems(const DrawItem* preview = nullptr);
-
-    // hit-test：是否被橡皮命中（简单基于 bounding box / 距离）
-    bool ItemHitTest(const DrawItem& item, const QVector<QPoint>& eraserPath, int eraserRadius) const;
+    // 重建 canvas_ 中的脏 tile（只在 items_ 变化后有事可做）
+    void RepaintCanvasFromItems();
+    // 把一个新提交的 item 直接叠加到它覆盖的 tile 上（无需重放全部 items_）
+    void AppendItemToCanvas(const DrawItem& item);
+    // items_ 发生非追加式变化（对象擦除等）后调用，标记 area 覆盖的 tile 待重建
+    void InvalidateCanvas(const QRect& area);
+    // 从 base + items_ 生成 area 范围内的最终像素（TiledCanvas 的 renderer）
+    void RenderCanvasArea(QPixmap& patch, const QRect& area) const;
+    // 只刷新 canvas 坐标 area 对应的屏幕区域
+    void UpdateCanvasArea(const QRect& area);
+    // 把 item 画到 target 上；origin 为 target 左上角在画布坐标系中的位置
+    void DrawItemOnto(QPixmap& target, const DrawItem& item, const QPoint& origin) const;
+    // 在 paintEvent 中把未提交的 preview_item_ 叠加在已提交图层之上
+    void PaintPreviewItem(QPainter& painter, const QRect& target, const QRect& src) const;
+    // item 在画布坐标系中影响到的范围（包含线宽 / 箭头）
+    static QRect ItemBounds(const DrawItem& item);
+
+    // 提交一个新对象：加入 items_、空间索引、canvas_ 和撤销记录
+    void CommitItem(DrawItem item);
+    // 维护对象橡皮用的空间索引，items_ 每次增删改都要同步
+    void IndexItem(const DrawItem& item);
+    // hit-test：返回被擦除轨迹碰到的对象在 items_ 中的下标（升序）
+    QVector<int> HitTestItems(const QVector<QPoint>& eraserPath, int eraserRadius) const;
 
 
     // ---------- 成员变量 ----------
@@ -132,11 +171,13 @@ private:
 
     QPixmap background_;   // 整个屏幕截图
     QRect   selection_;    // 当前选区
-    QPixmap canvas_;       // 选区内部绘制用的画布
+    TiledCanvas canvas_;   // 选区内部绘制用的画布（分块，按 tile 记录脏区）
 
     QPixmap base_pixmap_;                    // 进入编辑时保存的原始选区像素（canvas 的底）
     QVector<DrawItem> items_;                // 已提交的绘制对象
     std::unique_ptr<DrawItem> preview_item_; // 当前未提交的预览项（鼠标拖动时）
+    SpatialGrid hit_index_;                  // items_ 的网格索引（对象橡皮命中测试）
+    quint64 next_item_id_ = 1;
 
     double  zoom_scale_ = 1.0; // 选区内容缩放比例
     QPointF zoom_center_;
@@ -154,9 +195,11 @@ private:
     int    stroke_width_ = 4;                    // 形状/画笔/橡皮擦的粗细
     // 画笔 / 橡皮参数
 
-    // 撤销 / 重做栈（保存 image + items）
-    QVector<UndoState> undo_stack_;
-    QVector<UndoState> redo_stack_;
+    // 撤销 / 重做栈（保存对 items 的操作命令）
+    QVector<EditCommand> undo_stack_;
+    QVector<EditCommand> redo_stack_;
+    qint64 undo_bytes_ = 0;                          // undo_stack_ 估算占用
+    qint64 undo_memory_budget_ = 64ll * 1024 * 1024; // 默认 64 MB
     EditorToolbar* toolbar_ = nullptr;  // 顶部主工具栏
     SecondaryToolBar* sToolbar_ = nullptr;  // 形状/画笔/橡皮擦二级工具栏
     QTimer hoverTimer_;
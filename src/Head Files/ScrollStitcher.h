@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QImage>
+#include <QPoint>
+#include <QVector>
+
+// 长截图拼接器：估计相邻两帧之间的垂直滚动量，只输出新露出的行
+// - 每帧抓到后只算一次指纹（逐行哈希 + 低分辨率亮度轮廓），上一帧的指纹缓存下来
+// - 变化检测：哈希全同直接判定无变化；否则比较亮度轮廓，容忍光标闪烁等小噪声
+// - 粗搜：用信息量足够（非纯色）且哈希唯一的行投票得到候选偏移
+// - 精搜：对候选偏移逐行比较重叠区的哈希，取匹配率最高者
+// - 已知参考帧后也可以只输入顶部探针条 + 底部新内容（pushBand），不必每次整帧
+// - 吸顶 / 吸底：第一次滚动时找出位置不变的顶部 / 底部行，之后只在两者之间的滚动区匹配；
+//   吸顶区域只随第一帧输出一次，吸底区域留到 finish() 时放在结果最后
+// - 全景：第一次移动在垂直方向找不到重叠、但能用 2D 锚点块匹配到横向 / 斜向平移时，
+//   本次截图改为全景模式，之后每帧给出在画布上的位置（placements），由调用方贴到稀疏画布上
+// 不依赖任何 GUI 对象，只处理 QImage
+class ScrollStitcher
+{
+public:
+    // 每行分成多少段求平均亮度
+    static constexpr int kLumaBins = 16;
+
+    struct Fingerprint {
+        QSize size;
+        QVector<quint64> rows;   // 逐行哈希（忽略 alpha）
+        QVector<bool> flat;      // 该行是否为纯色
+        QVector<quint8> luma;    // 行优先，每行 kLumaBins 个平均亮度
+
+        bool isNull() const { return rows.isEmpty(); }
+    };
+
+    struct Match {
+        bool matched = false;    // 是否找到可信的滚动量
+        int offset = 0;          // 内容上移的行数（cur 的第 y 行 == prev 的第 y + offset 行）
+        int offsetX = 0;         // 内容左移的列数，只有 2D 估计会给出非 0 值
+        double confidence = 0;   // 重叠区有效行的匹配率 0-1
+    };
+
+    struct Result {
+        bool changed = false;    // 与上一帧相比内容是否有变化
+        Match match;
+        QImage band;             // 需要追加到结果末尾的新内容（可能为空）
+        bool needFullFrame = false;  // 分段抓取无法可靠衔接，下一次需要抓整帧
+        bool overlapLost = false;    // 有变化但找不到重叠（滚动太快），结果里可能漏了内容
+        bool stickyChanged = false;  // 本帧确定了吸顶 / 吸底区域
+        // 全景模式：需要贴到画布上的图像及其左上角位置（第一帧在 (0, 0)）
+        struct Placement {
+            QPoint pos;
+            QImage image;
+        };
+        QVector<Placement> placements;
+        bool panoramaStarted = false;  // 本帧切换到了全景模式，之后不再输出 band
+    };
+
+    void reset();
+
+    // 输入新的一帧和它的指纹，返回需要追加的部分。
+    // 第一帧先留着，等第一次滚动确定吸顶 / 吸底后再和新内容一起返回；判定为无变化时不更新参考帧
+    Result push(const QImage& frame, const Fingerprint& fingerprint);
+    Result push(const QImage& frame) { return push(frame, fingerprintOf(frame)); }
+
+    // 分段抓取：probe 是选区顶部的几行（含吸顶区域，估计滚动量），tail 是选区底部的若干行（含吸底区域，取新内容）。
+    // 校验通过时只追加新露出的部分并平移参考帧指纹；否则置 needFullFrame
+    Result pushBand(const QImage& probe, const QImage& tail);
+
+    // 结束拼接：返回还没输出的部分（一直没滚动时的第一帧，或吸底区域）
+    QImage finish();
+
+    const Fingerprint& lastFingerprint() const { return prev_; }
+    int headerRows() const { return headerRows_; }
+    int footerRows() const { return footerRows_; }
+    bool isPanorama() const { return panorama_; }
+
+    static Fingerprint fingerprintOf(const QImage& frame);
+    static bool isChanged(const Fingerprint& prev, const Fingerprint& cur);
+    // cur 可以是完整一帧，也可以只是顶部的探针条（行数不超过 prev）
+    static Match estimateOffset(const Fingerprint& prev, const Fingerprint& cur);
+    // 2D 平移估计：在 prev 上取哈希唯一的小块做锚点，在 cur 上滚动哈希投票，再分段校验重叠区。
+    // 两帧尺寸必须相同
+    static Match estimateShift(const QImage& prev, const QImage& cur);
+
+    // 认为匹配可信的最低匹配率
+    static constexpr double kMinConfidence = 0.9;
+    // 亮度轮廓平均差超过这个值才算内容变化
+    static constexpr double kChangeThreshold = 2.0;
+
+private:
+    static Fingerprint sliceRows(const Fingerprint& fp, int from, int count);
+    static void detectSticky(const Fingerprint& prev, const Fingerprint& cur, int& header, int& footer);
+    static QImage stackRows(const QImage& top, const QImage& bottom);
+    QImage flushFirstFrame(const QImage& newRows);
+    QImage regionOf(const QImage& frame) const;
+    Result startPanorama(const QImage& frame, const Fingerprint& fingerprint, const Match& shift, int header, int footer);
+    Result pushPanorama(const QImage& frame, const Fingerprint& fingerprint);
+
+    Fingerprint prev_;
+    QImage prevFrame_;         // 参考帧的像素（2D 估计要用）
+    QImage pendingFirst_;      // 第一帧，等第一次滚动后再输出
+    QImage footerImage_;       // 吸底区域，finish() 时输出
+    int headerRows_ = 0;
+    int footerRows_ = 0;
+    bool stickyKnown_ = false; // 吸顶 / 吸底是否已经确定
+    bool panorama_ = false;    // 全景模式
+    QPoint framePos_;          // 全景模式下参考帧（去掉吸顶 / 吸底后）在画布上的位置
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QImage>
+#include <QVector>
+#include <memory>
+
+class QTemporaryFile;
+
+// 长截图分段存储：按追加顺序保存拼接出的各段图像
+// - 内存中只保留最近的若干段，总量超过预算后把更早的段压缩写入临时文件
+// - 读取已落盘的段时从文件懒加载并解压，不会重新驻留内存
+// - 最新一段永远留在内存里（拼接时要用到）
+class SegmentStore
+{
+public:
+    explicit SegmentStore(qint64 memoryBudget = 256ll * 1024 * 1024);
+    ~SegmentStore();
+
+    SegmentStore(const SegmentStore&) = delete;
+    SegmentStore& operator=(const SegmentStore&) = delete;
+
+    void clear();
+
+    // 内存预算（字节），调小后会立刻把超出的部分落盘
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return memoryBudget_; }
+    qint64 memoryUsage() const { return memoryBytes_; }
+    qint64 diskUsage() const { return diskBytes_; }
+
+    void append(const QImage& segment);
+
+    bool isEmpty() const { return entries_.isEmpty(); }
+    int count() const { return entries_.size(); }
+    int width() const { return entries_.isEmpty() ? 0 : entries_.first().width; }
+    int height(int index) const { return entries_[index].height; }
+    qint64 totalHeight() const { return totalHeight_; }
+
+    // 第 index 段的像素；已落盘的段会从临时文件读回（失败时返回空图）
+    QImage at(int index) const;
+
+private:
+    struct Entry {
+        QImage image;              // 驻留内存时有效
+        qint64 fileOffset = -1;    // 落盘后在临时文件中的位置
+        qint64 fileSize = 0;
+        int width = 0;
+        int height = 0;
+        QImage::Format format = QImage::Format_Invalid;
+    };
+
+    void spill();
+    bool spillEntry(Entry& entry);
+
+    QVector<Entry> entries_;
+    std::unique_ptr<QTemporaryFile> file_;
+    qint64 memoryBudget_;
+    qint64 memoryBytes_ = 0;
+    qint64 diskBytes_ = 0;
+    qint64 totalHeight_ = 0;
+    int firstResident_ = 0;        // 此下标之前的段都已落盘
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QHash>
+#include <QLineF>
+#include <QPoint>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+
+// 均匀网格空间索引：给对象橡皮做命中测试用
+// - 每个对象（用稳定的 key 标识）登记为若干条带宽度的线段，或一个实心区域
+// - 线段 / 区域按外接矩形登记到覆盖的网格单元里
+// - 查询时只检查擦除轨迹经过的单元，再做精确的线段-线段 / 线段-矩形距离判断
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(int cellSize = 64);
+
+    void clear();
+
+    // 登记折线（相邻两点构成一条线段，单点视为长度为 0 的线段），halfWidth 为线宽一半
+    void insertPolyline(quint64 key, const QVector<QPointF>& points, qreal halfWidth);
+    // 登记实心区域（马赛克 / 模糊 / 矩形框等按整块区域命中）
+    void insertArea(quint64 key, const QRectF& rect);
+    void remove(quint64 key);
+    bool contains(quint64 key) const { return shapes_.contains(key); }
+
+    // 返回与擦除轨迹（半径 radius）接触到的对象 key
+    QSet<quint64> query(const QVector<QPoint>& path, qreal radius) const;
+
+    // 几何工具
+    static qreal SegmentDistance(const QLineF& a, const QLineF& b);
+    static qreal SegmentRectDistance(const QLineF& s, const QRectF& rect);
+
+private:
+    struct Shape {
+        QVector<QLineF> segments;
+        qreal halfWidth = 0;
+        bool isArea = false;
+        QRectF area;
+    };
+    struct Ref {
+        quint64 key;
+        int segment;   // 区域对象为 -1
+    };
+
+    QRect cellRange(const QRectF& r) const;
+    static quint64 cellKey(int cx, int cy);
+    void registerRef(const QRectF& bounds, const Ref& ref);
+
+    int cell_size_;
+    QHash<quint64, Shape> shapes_;
+    QHash<quint64, QVector<Ref>> cells_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QString>
+#include <memory>
+
+// 流式 PNG 编码：先写文件头，再一段一段追加扫描线，最后补上结束块
+// - 整张图不需要出现在内存里，峰值内存只和单段大小有关
+// - 输出 8 位 RGB（长截图不带透明），高度上限是 PNG 规范的 2^31-1
+// - 每行使用 Sub 过滤，zlib 流跨段连续，按 64KB 切成 IDAT 块写出
+class StreamingPngWriter
+{
+public:
+    StreamingPngWriter();
+    ~StreamingPngWriter();
+
+    StreamingPngWriter(const StreamingPngWriter&) = delete;
+    StreamingPngWriter& operator=(const StreamingPngWriter&) = delete;
+
+    // 写入文件头，声明最终尺寸
+    bool open(const QString& path, int width, qint64 height);
+    // 追加若干行；宽度必须与 open 时一致，总行数不能超过声明的高度
+    bool writeRows(const QImage& rows);
+    // 写完全部行后调用；行数不足时返回 false 并删除文件
+    bool close();
+
+    qint64 rowsWritten() const { return rowsWritten_; }
+    QString errorString() const { return error_; }
+
+private:
+    bool deflateInput(const uchar* data, size_t size, bool finish);
+    bool flushIdat(bool all);
+    bool writeChunk(const char* type, const QByteArray& data);
+    bool fail(const QString& message);
+
+    struct Deflater;   // 包一层 z_stream，头文件里不暴露 zlib
+
+    QFile file_;
+    std::unique_ptr<Deflater> deflater_;
+    QByteArray pending_;     // 已压缩但还没写成 IDAT 的数据
+    QByteArray rowBuffer_;   // 一行过滤后的数据（含过滤类型字节）
+    int width_ = 0;
+    qint64 height_ = 0;
+    qint64 rowsWritten_ = 0;
+    QString error_;
+};
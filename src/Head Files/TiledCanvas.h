@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QPixmap>
+#include <QRect>
+#include <QVector>
+#include <functional>
+
+class QPainter;
+
+// 分块画布：把编辑画布切成固定大小的 tile，并按 tile 记录脏区
+// - 提交 / 擦除一个对象时只重建它外接矩形覆盖到的 tile
+// - 绘制时只画与暴露区域相交的 tile
+// 坐标一律使用画布坐标（相对于选区左上角）
+class TiledCanvas
+{
+public:
+    static constexpr int kTileSize = 256;
+
+    // 在 patch 上生成 area（画布坐标）范围内的最终像素，patch 尺寸等于 area 尺寸
+    using Renderer = std::function<void(QPixmap& patch, const QRect& area)>;
+
+    // 用整张图初始化（切分成 tile），所有 tile 视为干净
+    void reset(const QPixmap& pixmap);
+    void clear();
+
+    bool isNull() const { return tiles_.isEmpty(); }
+    QSize size() const { return size_; }
+    QRect rect() const { return QRect(QPoint(0, 0), size_); }
+
+    // 标记 area 覆盖到的 tile 需要重建
+    void markDirty(const QRect& area);
+    bool hasDirty() const { return dirty_count_ > 0; }
+
+    // 重建所有脏 tile：相邻脏 tile 合并成矩形，每个矩形调用一次 renderer
+    // 返回重建的 tile 数
+    int recompose(const Renderer& renderer);
+
+    // 原地修改 area 范围：取出像素 -> fn -> 写回覆盖到的 tile（用于追加绘制）
+    void modify(const QRect& area, const Renderer& fn);
+
+    // 拼出 area 范围的像素（导出 / 预览取底图用）
+    QPixmap copy(const QRect& area) const;
+    QPixmap toPixmap() const { return copy(rect()); }
+
+    // 按 drawPixmap(target, canvas, src) 的映射绘制，只画与 exposed（widget 坐标）相交的 tile
+    void draw(QPainter& painter, const QRect& target, const QRect& src, const QRect& exposed) const;
+
+private:
+    QRect tileRect(int col, int row) const;
+    void write(const QPixmap& patch, const QRect& area);
+
+    QSize size_;
+    int cols_ = 0;
+    int rows_ = 0;
+    QVector<QPixmap> tiles_;   // 行优先
+    QVector<bool> dirty_;
+    int dirty_count_ = 0;
+};
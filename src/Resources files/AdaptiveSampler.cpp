@@ -0,0 +1,65 @@
+#include "AdaptiveSampler.h"
+
+#include <cmath>
+
+namespace {
+    constexpr double kFastScrollFraction = 0.5;   // 一帧滚过半屏以上，必须加快
+    constexpr double kSlowScrollFraction = 0.15;  // 一帧不到 15%，可以放宽
+    constexpr double kRateSmoothing = 0.2;        // 滑动平均的新样本权重
+}
+
+AdaptiveSampler::AdaptiveSampler(int minMs, int maxMs, int initialMs)
+    : minMs_(minMs)
+    , maxMs_(qMax(minMs, maxMs))
+    , initialMs_(qBound(minMs, initialMs, qMax(minMs, maxMs)))
+    , interval_(initialMs_)
+{
+}
+
+void AdaptiveSampler::reset()
+{
+    interval_ = initialMs_;
+    lastGrabMs_ = -1;
+    avgGrabGapMs_ = 0;
+}
+
+void AdaptiveSampler::setInterval(double ms)
+{
+    interval_ = qBound(minMs_, int(std::lround(ms)), maxMs_);
+}
+
+void AdaptiveSampler::onMotion(double fraction)
+{
+    if (fraction > kFastScrollFraction) {
+        setInterval(interval_ / 2.0);
+    }
+    else if (fraction < kSlowScrollFraction) {
+        setInterval(interval_ * 1.25);
+    }
+}
+
+void AdaptiveSampler::onStatic()
+{
+    setInterval(interval_ * 2.0);
+}
+
+void AdaptiveSampler::onActivity()
+{
+    interval_ = minMs_;
+}
+
+void AdaptiveSampler::onFrameGrabbed(qint64 nowMs)
+{
+    if (lastGrabMs_ >= 0) {
+        const double gap = double(nowMs - lastGrabMs_);
+        avgGrabGapMs_ = avgGrabGapMs_ <= 0
+            ? gap
+            : avgGrabGapMs_ + (gap - avgGrabGapMs_) * kRateSmoothing;
+    }
+    lastGrabMs_ = nowMs;
+}
+
+double AdaptiveSampler::rate() const
+{
+    return avgGrabGapMs_ > 0 ? 1000.0 / avgGrabGapMs_ : 0.0;
+}
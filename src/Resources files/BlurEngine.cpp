@@ -0,0 +1,199 @@
+#include "BlurEngine.h"
+
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+    constexpr int kPasses = 3;
+    constexpr int kMinPixelsPerTask = 64 * 1024;   // 单个并行任务至少处理的像素数
+
+    struct Buffer {
+        uchar* bits = nullptr;
+        qsizetype stride = 0;
+        int width = 0;
+        int height = 0;
+
+        QRgb* line(int y) const { return reinterpret_cast<QRgb*>(bits + y * stride); }
+    };
+
+    // 把 [0, count) 拆成若干段并行执行；第一段在当前线程跑，线程池满时退回当前线程
+    void ParallelRanges(int count, int minChunk, const std::function<void(int, int)>& fn)
+    {
+        const int chunks = qBound(1, count / qMax(1, minChunk), qMax(1, QThread::idealThreadCount()));
+        if (chunks <= 1) {
+            fn(0, count);
+            return;
+        }
+
+        const int step = (count + chunks - 1) / chunks;
+        QSemaphore done;
+        int started = 0;
+        for (int begin = step; begin < count; begin += step) {
+            const int end = qMin(count, begin + step);
+            std::function<void()> task = [&fn, &done, begin, end]() {
+                fn(begin, end);
+                done.release();
+                };
+            if (!QThreadPool::globalInstance()->tryStart(task)) {
+                task();
+            }
+            ++started;
+        }
+        fn(0, qMin(count, step));
+        done.acquire(started);
+    }
+
+    // 定点除法：sum * mul >> 16，mul 向下取整保证结果不超过 255
+    inline quint32 Average(quint32 sum, quint32 mul)
+    {
+        return (sum * mul + 0x8000) >> 16;
+    }
+
+    // 水平方向一趟：对 [y0, y1) 行做半径 r 的滑动窗口求平均
+    void BoxRows(const Buffer& src, const Buffer& dst, int r, int y0, int y1)
+    {
+        const int w = src.width;
+        const quint32 mul = (1u << 16) / quint32(2 * r + 1);
+
+        for (int y = y0; y < y1; ++y) {
+            const QRgb* in = src.line(y);
+            QRgb* out = dst.line(y);
+
+            quint32 sa = 0, sr = 0, sg = 0, sb = 0;
+            for (int k = -r; k <= r; ++k) {
+                const QRgb p = in[qBound(0, k, w - 1)];
+                sa += qAlpha(p);
+                sr += qRed(p);
+                sg += qGreen(p);
+                sb += qBlue(p);
+            }
+            for (int x = 0; x < w; ++x) {
+                out[x] = qRgba(Average(sr, mul), Average(sg, mul), Average(sb, mul), Average(sa, mul));
+                const QRgb add = in[qMin(x + r + 1, w - 1)];
+                const QRgb sub = in[qMax(x - r, 0)];
+                sa += qAlpha(add) - qAlpha(sub);
+                sr += qRed(add) - qRed(sub);
+                sg += qGreen(add) - qGreen(sub);
+                sb += qBlue(add) - qBlue(sub);
+            }
+        }
+    }
+
+    // 垂直方向一趟：对 [x0, x1) 列做滑动窗口求平均。
+    // 每一列维护一组累加和，按行推进，这样读写仍然是连续的扫描线
+    void BoxColumns(const Buffer& src, const Buffer& dst, int r, int x0, int x1)
+    {
+        const int h = src.height;
+        const int n = x1 - x0;
+        const quint32 mul = (1u << 16) / quint32(2 * r + 1);
+        std::vector<quint32> sums(size_t(n) * 4, 0);
+
+        auto accumulate = [&](int y, int sign) {
+            const QRgb* in = src.line(qBound(0, y, h - 1)) + x0;
+            quint32* s = sums.data();
+            for (int x = 0; x < n; ++x, s += 4) {
+                const QRgb p = in[x];
+                s[0] += quint32(sign * qAlpha(p));
+                s[1] += quint32(sign * qRed(p));
+                s[2] += quint32(sign * qGreen(p));
+                s[3] += quint32(sign * qBlue(p));
+            }
+            };
+
+        for (int k = -r; k <= r; ++k) {
+            accumulate(k, 1);
+        }
+        for (int y = 0; y < h; ++y) {
+            QRgb* out = dst.line(y) + x0;
+            const quint32* s = sums.data();
+            for (int x = 0; x < n; ++x, s += 4) {
+                out[x] = qRgba(Average(s[1], mul), Average(s[2], mul), Average(s[3], mul), Average(s[0], mul));
+            }
+            accumulate(y + r + 1, 1);
+            accumulate(y - r, -1);
+        }
+    }
+
+    // 按 strength 把模糊结果和原图混合：out = orig + (blur - orig) * strength
+    void BlendRows(const Buffer& original, const Buffer& blurred, int strength, int y0, int y1)
+    {
+        const int s = strength * 256 / 100;
+        auto mix = [s](int o, int b) { return o + (((b - o) * s) >> 8); };
+
+        for (int y = y0; y < y1; ++y) {
+            const QRgb* o = original.line(y);
+            QRgb* b = blurred.line(y);
+            for (int x = 0; x < original.width; ++x) {
+                b[x] = qRgba(mix(qRed(o[x]), qRed(b[x])), mix(qGreen(o[x]), qGreen(b[x])),
+                    mix(qBlue(o[x]), qBlue(b[x])), mix(qAlpha(o[x]), qAlpha(b[x])));
+            }
+        }
+    }
+
+    Buffer BufferOf(QImage& image)
+    {
+        // bits() 可能触发 detach，必须在分发给工作线程之前取好
+        return Buffer{ image.bits(), image.bytesPerLine(), image.width(), image.height() };
+    }
+
+} // namespace
+
+int BlurEngine::boxRadiusFor(int radius)
+{
+    // 三个宽度为 2r+1 的盒子叠加，方差为 3 * ((2r+1)^2 - 1) / 12 = r(r+1)，
+    // 令其等于 (radius / 2)^2 解出 r
+    return qMax(1, qRound((std::sqrt(double(radius) * radius + 1.0) - 1.0) / 2.0));
+}
+
+void BlurEngine::blur(QImage& image, const QRect& area, int radius, int strength)
+{
+    if (image.isNull() || area.isEmpty() || radius < 1) {
+        return;
+    }
+    strength = qBound(0, strength, 100);
+    if (strength == 0) {
+        return;
+    }
+
+    const QRect effectiveArea = area.intersected(image.rect());
+    if (effectiveArea.isEmpty()) return;
+
+    // 统一成 32 位格式（预乘，透明像素不会把颜色带进邻居），只复制 area 范围处理
+    if (image.format() != QImage::Format_ARGB32_Premultiplied &&
+        image.format() != QImage::Format_RGB32) {
+        image.convertTo(QImage::Format_ARGB32_Premultiplied);
+    }
+    QImage work = image.copy(effectiveArea);
+    QImage original = strength < 100 ? work.copy() : QImage();
+    QImage temp(work.size(), work.format());
+
+    const Buffer a = BufferOf(work);
+    const Buffer b = BufferOf(temp);
+    const int r = boxRadiusFor(radius);
+    const int w = a.width;
+    const int h = a.height;
+    const int minRows = qMax(1, kMinPixelsPerTask / w);
+    const int minCols = qMax(1, kMinPixelsPerTask / h);
+
+    for (int pass = 0; pass < kPasses; ++pass) {
+        ParallelRanges(h, minRows, [&](int y0, int y1) { BoxRows(a, b, r, y0, y1); });
+        ParallelRanges(w, minCols, [&](int x0, int x1) { BoxColumns(b, a, r, x0, x1); });
+    }
+
+    if (!original.isNull()) {
+        const Buffer o = BufferOf(original);
+        ParallelRanges(h, minRows, [&](int y0, int y1) { BlendRows(o, a, strength, y0, y1); });
+    }
+
+    // 写回原图的 area 范围
+    for (int y = 0; y < h; ++y) {
+        memcpy(reinterpret_cast<QRgb*>(image.scanLine(effectiveArea.top() + y)) + effectiveArea.left(),
+            a.line(y), size_t(w) * sizeof(QRgb));
+    }
+}
@@ -1,17 +1,17 @@
 #include "BlurTool.h"
+#include "BlurEngine.h"
 #include <QPainter>
-#include <QGraphicsBlurEffect>
+#include <QImage>
 #include <QSlider>
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QGraphicsScene>
-#include <QGraphicsPixmapItem>
+#include <functional>
 
 BlurTool::BlurTool(QObject* parent) : QObject(parent) {
 }
 
-void BlurTool::applyEffect(QPixmap& pixmap, const QRect& area, int opacity) {
+void BlurTool::applyEffect(QPixmap& pixmap, const QRect& area, int radius, int opacity) {
     if (pixmap.isNull() || area.isEmpty()) {
         return;
     }
@@ -20,32 +20,18 @@ void BlurTool::applyEffect(QPixmap& pixmap, const QRect& area, int opacity) {
     QRect effectiveArea = area.intersected(pixmap.rect());
     if (effectiveArea.isEmpty()) return;
 
-    // ʱͼģ
-    QPixmap temp = pixmap.copy(effectiveArea);
-
-    // ʹQGraphicsEffectи˹ģ
-    QGraphicsBlurEffect* blurEffect = new QGraphicsBlurEffect();
-    blurEffect->setBlurRadius(15); // ̶ģ뾶
-
-    QGraphicsScene scene;
-    QGraphicsPixmapItem item(temp);
-    item.setGraphicsEffect(blurEffect);
-    scene.addItem(&item);
-
-    // Ⱦģͼ
-    QPixmap blurred(temp.size());
-    blurred.fill(Qt::transparent);
-    QPainter painter(&blurred);
-    scene.render(&painter);
-
-    // ͸Ȼ
     opacity = qBound(0, opacity, 100);
-    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-    painter.setOpacity(opacity / 100.0);
+    if (opacity == 0) return;
+
+    // ֻȡӰͼڴֱģ
+    QImage image = pixmap.copy(effectiveArea).toImage()
+        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    BlurEngine::blur(image, image.rect(), qBound(1, radius, 50), opacity);
 
     // ģƻԭͼ
-    QPainter mainPainter(&pixmap);
-    mainPainter.drawPixmap(effectiveArea.topLeft(), blurred);
+    QPainter painter(&pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(effectiveArea.topLeft(), image);
 }
 
 void BlurTool::setOpacity(int opacity) {
@@ -56,6 +42,14 @@ void BlurTool::setOpacity(int opacity) {
     }
 }
 
+void BlurTool::setRadius(int radius) {
+    radius = qBound(1, radius, 50);
+    if (m_radius != radius) {
+        m_radius = radius;
+        emit radiusChanged(radius);
+    }
+}
+
 QWidget* BlurTool::createSettingsWidget(QWidget* parent) {
     auto* popup = new QWidget(parent, Qt::Popup | Qt::FramelessWindowHint);
     popup->setAttribute(Qt::WA_TranslucentBackground);
@@ -71,33 +65,38 @@ QWidget* BlurTool::createSettingsWidget(QWidget* parent) {
     layout->setContentsMargins(10, 8, 10, 8);
     layout->setSpacing(8);
 
-    // 
-    auto* titleLabel = new QLabel("diaphaneity", container);
-    titleLabel->setStyleSheet("font-weight: bold; border: none;");
-    layout->addWidget(titleLabel);
-
-    // 
-    auto* sliderLayout = new QHBoxLayout();
-    sliderLayout->setSpacing(8);
-
-    auto* slider = new QSlider(Qt::Horizontal, container);
-    slider->setRange(0, 100);
-    slider->setValue(m_opacity);
-    slider->setFixedWidth(200);
-
-    auto* valueLabel = new QLabel(QString::number(m_opacity), container);
-    valueLabel->setFixedWidth(30);
-    valueLabel->setStyleSheet("border: none;");
-
-    sliderLayout->addWidget(slider);
-    sliderLayout->addWidget(valueLabel);
-    layout->addLayout(sliderLayout);
-
-    // ź
-    connect(slider, &QSlider::valueChanged, [this, valueLabel](int value) {
-        setOpacity(value);
-        valueLabel->setText(QString::number(value));
-        });
+    // һУ +  + ֵ
+    auto addSliderRow = [container, layout](const QString& title, int minimum, int maximum, int value,
+        const std::function<void(int)>& onChanged) {
+            auto* titleLabel = new QLabel(title, container);
+            titleLabel->setStyleSheet("font-weight: bold; border: none;");
+            layout->addWidget(titleLabel);
+
+            auto* sliderLayout = new QHBoxLayout();
+            sliderLayout->setSpacing(8);
+
+            auto* slider = new QSlider(Qt::Horizontal, container);
+            slider->setRange(minimum, maximum);
+            slider->setValue(value);
+            slider->setFixedWidth(200);
+
+            auto* valueLabel = new QLabel(QString::number(value), container);
+            valueLabel->setFixedWidth(30);
+            valueLabel->setStyleSheet("border: none;");
+
+            sliderLayout->addWidget(slider);
+            sliderLayout->addWidget(valueLabel);
+            layout->addLayout(sliderLayout);
+
+            // ź
+            QObject::connect(slider, &QSlider::valueChanged, [valueLabel, onChanged](int v) {
+                onChanged(v);
+                valueLabel->setText(QString::number(v));
+                });
+        };
+
+    addSliderRow("radius", 1, 50, m_radius, [this](int value) { setRadius(value); });
+    addSliderRow("diaphaneity", 0, 100, m_opacity, [this](int value) { setOpacity(value); });
 
     auto* mainLayout = new QVBoxLayout(popup);
     mainLayout->setContentsMargins(0, 0, 0, 0);
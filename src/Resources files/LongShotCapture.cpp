@@ -7,6 +7,7 @@
 #include <QImage>
 #include <QClipboard>
 #include <QFileDialog>
+#include <QMessageBox>
 #include <QStandardPaths>
 #include <QDir>
 #include <QDateTime>
@@ -15,18 +16,79 @@
 #include <QDebug>
 #include <QWheelEvent>
 #include <QDebug>
+#include <QFileInfo>
+#include <QtMath>
+#include "StreamingPngWriter.h"
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
 
+namespace {
+#ifdef Q_OS_WIN
+    // 低级鼠标钩子：overlay 鼠标穿透后滚轮直接发给目标窗口，只能这样感知滚动
+    HHOOK g_wheelHook = nullptr;
+    QPointer<LongShotCapture> g_wheelHookOwner;
+
+    LRESULT CALLBACK WheelHookProc(int code, WPARAM wParam, LPARAM lParam)
+    {
+        if (code == HC_ACTION && (wParam == WM_MOUSEWHEEL || wParam == WM_MOUSEHWHEEL) && g_wheelHookOwner) {
+            QMetaObject::invokeMethod(g_wheelHookOwner.data(), "onScrollActivity", Qt::QueuedConnection);
+        }
+        return CallNextHookEx(g_wheelHook, code, wParam, lParam);
+    }
+#endif
+
+    constexpr int kPreviewStripWidth = LongShotWorker::kPreviewWidth;
+    // 最多允许排队的帧数，worker 跟不上时丢弃新抓到的帧
+    constexpr int kMaxPendingFrames = 2;
+    // 分段抓取：顶部探针条的行数范围，底部新内容区域的最少行数和额外余量
+    constexpr int kMinProbeRows = 32;
+    constexpr int kMaxProbeRows = 128;
+    constexpr int kMinTailRows = 64;
+    constexpr int kTailMarginRows = 32;
+    // 超过这个高度（全景模式下宽高都算）就不再整图合成（剪贴板 / 非 PNG 格式），只走流式 PNG
+    constexpr qint64 kMaxComposeHeight = 32767;
+}
+
 LongShotCapture::LongShotCapture(QObject* parent)
     : QObject(parent)
 {
-    // 200ms 一次，可以根据体验再调整
-    timer_.setInterval(200);
+    // 初始 200ms 一次，之后由 sampler_ 按画面运动自适应调整
+    timer_.setInterval(sampler_.interval());
     timer_.setSingleShot(false);
     connect(&timer_, &QTimer::timeout,
         this, &LongShotCapture::onTick);
+
+    worker_ = new LongShotWorker;
+    worker_->moveToThread(&workerThread_);
+    connect(&workerThread_, &QThread::finished, worker_, &QObject::deleteLater);
+    connect(worker_, &LongShotWorker::previewBandReady,
+        this, &LongShotCapture::onPreviewBand, Qt::QueuedConnection);
+    connect(worker_, &LongShotWorker::frameProcessed,
+        this, &LongShotCapture::onFrameProcessed, Qt::QueuedConnection);
+    connect(worker_, &LongShotWorker::fullFrameRequested,
+        this, &LongShotCapture::onFullFrameRequested, Qt::QueuedConnection);
+    connect(worker_, &LongShotWorker::stickyRegionsChanged,
+        this, &LongShotCapture::onStickyRegions, Qt::QueuedConnection);
+    connect(worker_, &LongShotWorker::panoramaStarted,
+        this, &LongShotCapture::onPanoramaStarted, Qt::QueuedConnection);
+    connect(worker_, &LongShotWorker::panoramaPreviewReady,
+        this, &LongShotCapture::onPanoramaPreview, Qt::QueuedConnection);
+    workerThread_.setObjectName("LongShotWorker");
+    workerThread_.start();
+}
+
+LongShotCapture::~LongShotCapture()
+{
+    stop();
+    workerThread_.quit();
+    workerThread_.wait();
+}
+
+void LongShotCapture::setMemoryBudget(qint64 bytes)
+{
+    QMetaObject::invokeMethod(worker_, [w = worker_, bytes]() { w->setMemoryBudget(bytes); },
+        Qt::QueuedConnection);
 }
 
 void LongShotCapture::start(const QRect& selectionInOverlay,
@@ -50,8 +112,24 @@ void LongShotCapture::start(const QRect& selectionInOverlay,
 
     qDebug() << "[LongShot] captureRectGlobal_ =" << captureRectGlobal_;
 
-    segments_.clear();
-    previewPixmap_ = QPixmap();
+    // 新的 generation：worker 清空状态，旧的排队结果回来后直接丢弃
+    ++generation_;
+    grabbedFrames_ = 0;
+    overlapWarnings_ = 0;
+    needFullFrame_ = true;
+    lastMotionRows_ = 0;
+    headerRows_ = 0;
+    footerRows_ = 0;
+    sampler_.reset();
+    clock_.start();
+    QMetaObject::invokeMethod(worker_, [w = worker_, g = generation_]() { w->reset(g); },
+        Qt::QueuedConnection);
+    previewStrip_.clear();
+    previewStripHeight_ = 0;
+    panorama_ = false;
+    panoramaPreview_ = QImage();
+    panelCache_ = QPixmap();
+    panelDirty_ = true;
 
 #ifdef Q_OS_WIN
     // 1) 让 Overlay 鼠标穿透
@@ -111,6 +189,12 @@ void LongShotCapture::start(const QRect& selectionInOverlay,
     else {
         qDebug() << "[LongShot] WARNING: failed to find targetWindow_";
     }
+
+    // 3) 监听滚轮，用户一滚动就加快采样
+    if (!g_wheelHook) {
+        g_wheelHook = SetWindowsHookEx(WH_MOUSE_LL, WheelHookProc, GetModuleHandle(nullptr), 0);
+    }
+    g_wheelHookOwner = this;
 #endif
 
     active_ = true;
@@ -119,7 +203,7 @@ void LongShotCapture::start(const QRect& selectionInOverlay,
     onTick();
     if (overlay_) overlay_->update();
 
-    timer_.start();
+    timer_.start(sampler_.interval());
     qDebug() << "[LongShot] timer started, interval =" << timer_.interval();
 }
 
@@ -142,6 +226,12 @@ void LongShotCapture::stop()
     }
 
     targetWindow_ = nullptr;
+
+    if (g_wheelHook && g_wheelHookOwner == this) {
+        UnhookWindowsHookEx(g_wheelHook);
+        g_wheelHook = nullptr;
+        g_wheelHookOwner = nullptr;
+    }
 #endif
 }
 
@@ -160,14 +250,79 @@ void LongShotCapture::onTick()
     if (!screen)
         return;
 
-    QPixmap frame;
+#ifdef Q_OS_WIN
+    // 第一次时，用与目标窗口的交集更新 captureRectGlobal_，保证后续尺寸一致
+    if (targetWindow_ && grabbedFrames_ == 0) {
+        RECT wr{};
+        if (!GetWindowRect(targetWindow_, &wr)) {
+            return;
+        }
+        QRect windowRect(wr.left, wr.top, wr.right - wr.left, wr.bottom - wr.top);
+        QRect inter = captureRectGlobal_.intersected(windowRect);
+        if (inter.isEmpty())
+            return;
+        captureRectGlobal_ = inter;
+    }
+#endif
+
+    // worker 跟不上时宁可丢帧，也不让队列无限增长
+    if (pendingFrames_ >= kMaxPendingFrames) {
+        qDebug() << "[LongShot] onTick: worker busy, dropping frame";
+        return;
+    }
+
+    const int h = captureRectGlobal_.height();
+    const int probeRows = qBound(kMinProbeRows, h / 8, kMaxProbeRows);
+    // 预计这次滚过的行数留足余量，再加上校验行
+    const int tailRows = qMax(kMinTailRows, lastMotionRows_ * 2 + kTailMarginRows);
+    // 吸顶 / 吸底区域由拼接器自己剥掉，这里只需要把它们一起抓进来
+    const int probeHeight = headerRows_ + probeRows;
+    const int tailHeight = tailRows + footerRows_;
+    const bool bandMode = !panorama_ && !needFullFrame_ && grabbedFrames_ > 0 && probeHeight + tailHeight < h;
+
+    if (bandMode) {
+        // 只抓顶部探针条 + 底部新内容，省掉中间大部分行
+        const QRect probeRect(captureRectGlobal_.left(), captureRectGlobal_.top(),
+            captureRectGlobal_.width(), probeHeight);
+        const QRect tailRect(captureRectGlobal_.left(), captureRectGlobal_.bottom() - tailHeight + 1,
+            captureRectGlobal_.width(), tailHeight);
+        const QPixmap probe = grabGlobal(screen, probeRect);
+        const QPixmap tail = grabGlobal(screen, tailRect);
+        if (probe.isNull() || tail.isNull())
+            return;
 
+        ++grabbedFrames_;
+        sampler_.onFrameGrabbed(clock_.elapsed());
+        ++pendingFrames_;
+        QMetaObject::invokeMethod(worker_,
+            [w = worker_, p = probe.toImage(), t = tail.toImage(), g = generation_]() { w->processBand(p, t, g); },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    const QPixmap frame = grabGlobal(screen, captureRectGlobal_);
+    if (frame.isNull())
+        return;
+
+    ++grabbedFrames_;
+    needFullFrame_ = false;
+    sampler_.onFrameGrabbed(clock_.elapsed());
+
+    // QPixmap 只能在 GUI 线程使用，转成 QImage 后交给 worker
+    ++pendingFrames_;
+    QMetaObject::invokeMethod(worker_,
+        [w = worker_, image = frame.toImage(), g = generation_]() { w->processFrame(image, g); },
+        Qt::QueuedConnection);
+}
+
+QPixmap LongShotCapture::grabGlobal(QScreen* screen, const QRect& rect) const
+{
 #ifdef Q_OS_WIN
     if (targetWindow_) {
         // --- 优先从目标窗口抓图（不会有 Overlay，所以不会闪） ---
         RECT wr{};
         if (!GetWindowRect(targetWindow_, &wr)) {
-            return;
+            return QPixmap();
         }
 
         QRect windowRect(wr.left,
@@ -175,140 +330,171 @@ void LongShotCapture::onTick()
             wr.right - wr.left,
             wr.bottom - wr.top);
 
-        // captureRectGlobal_ 与 windowRect 求交集，避免越界
-        QRect inter = captureRectGlobal_.intersected(windowRect);
+        // 与 windowRect 求交集，避免越界
+        QRect inter = rect.intersected(windowRect);
         if (inter.isEmpty())
-            return;
-
-        // 第一次时，用交集更新 captureRectGlobal_，保证后续尺寸一致
-        if (segments_.isEmpty()) {
-            captureRectGlobal_ = inter;
-        }
+            return QPixmap();
 
         // 抓窗口局部区域：坐标相对于窗口左上角
-        int x = inter.x() - windowRect.x();
-        int y = inter.y() - windowRect.y();
-        int w = inter.width();
-        int h = inter.height();
-
-        frame = screen->grabWindow(
+        return screen->grabWindow(
             (WId)targetWindow_,
-            x, y, w, h
+            inter.x() - windowRect.x(), inter.y() - windowRect.y(),
+            inter.width(), inter.height()
         );
     }
-    else
 #endif
-    {
-        // --- 没拿到目标窗口时，退回到抓整个桌面（这时可能会包含 Overlay） ---
-        const QRect& r = captureRectGlobal_;
-        frame = screen->grabWindow(
-            0,
-            r.x(), r.y(),
-            r.width(), r.height()
-        );
-    }
+    // --- 没拿到目标窗口时，退回到抓整个桌面（这时可能会包含 Overlay） ---
+    return screen->grabWindow(
+        0,
+        rect.x(), rect.y(),
+        rect.width(), rect.height()
+    );
+}
 
-    if (frame.isNull())
+void LongShotCapture::onPreviewBand(const QImage& band, int generation)
+{
+    if (generation != generation_ || band.isNull())
         return;
 
-    if (!segments_.isEmpty()) {
-        const QPixmap& last = segments_.last();
-        if (!isFrameDifferent(last, frame)) {
-            qDebug() << "[LongShot] onTick: frame same as last, segments_ size ="
-                << segments_.size();
-            return;
-        }
-    }
-
-    segments_.push_back(frame);
-    qDebug() << "[LongShot] onTick: captured new frame, segments_ size ="
-        << segments_.size();
-
-    updatePreview();
+    previewStrip_.push_back(band);
+    previewStripHeight_ += band.height();
+    panelDirty_ = true;
     if (overlay_) overlay_->update();
 }
 
-bool LongShotCapture::isFrameDifferent(const QPixmap& a, const QPixmap& b)
+void LongShotCapture::onFrameProcessed(int generation, bool changed, double motion, bool overlapLost)
 {
-    if (a.size() != b.size())
-        return true;
+    if (pendingFrames_ > 0)
+        --pendingFrames_;
+    if (generation != generation_ || !active_)
+        return;
 
-    QImage ia = a.toImage().convertToFormat(QImage::Format_RGB32);
-    QImage ib = b.toImage().convertToFormat(QImage::Format_RGB32);
+    lastMotionRows_ = changed ? qRound(motion * captureRectGlobal_.height()) : 0;
 
-    int w = ia.width();
-    int h = ia.height();
-    if (w <= 0 || h <= 0)
-        return false;
-
-    // 只关注“下方 1/3 区域”，更接近滚动时变化的区域
-    int startY = h * 2 / 3;
-    if (startY >= h) startY = 0;
-    int endY = h - 1;
+    if (overlapLost) {
+        ++overlapWarnings_;
+        qDebug() << "[LongShot] overlap lost, scrolled faster than sampling, warnings ="
+            << overlapWarnings_;
+    }
 
-    int stepY = qMax(1, (endY - startY) / 30); // 最多 30 行
-    int stepX = qMax(1, w / 50);               // 最多 50 列
+    if (!changed) {
+        sampler_.onStatic();
+    }
+    else {
+        sampler_.onMotion(motion);
+    }
+    if (timer_.interval() != sampler_.interval()) {
+        timer_.setInterval(sampler_.interval());
+    }
+}
 
-    double diffSum = 0.0;
-    int sampleCount = 0;
+void LongShotCapture::onFullFrameRequested(int generation)
+{
+    if (generation == generation_)
+        needFullFrame_ = true;
+}
 
-    for (int y = startY; y <= endY; y += stepY) {
-        const QRgb* pa = reinterpret_cast<const QRgb*>(ia.constScanLine(y));
-        const QRgb* pb = reinterpret_cast<const QRgb*>(ib.constScanLine(y));
+void LongShotCapture::onStickyRegions(int generation, double headerFraction, double footerFraction)
+{
+    if (generation != generation_)
+        return;
 
-        for (int x = 0; x < w; x += stepX) {
-            QRgb ca = pa[x];
-            QRgb cb = pb[x];
+    // worker 按物理像素计算，这里换算回逻辑像素并向上取整，保证抓取的条带完整包含固定区域
+    const int h = captureRectGlobal_.height();
+    headerRows_ = qCeil(headerFraction * h);
+    footerRows_ = qCeil(footerFraction * h);
+    qDebug() << "[LongShot] sticky header =" << headerRows_ << "footer =" << footerRows_ << "rows";
+}
 
-            int dr = qAbs(qRed(ca) - qRed(cb));
-            int dg = qAbs(qGreen(ca) - qGreen(cb));
-            int db = qAbs(qBlue(ca) - qBlue(cb));
+void LongShotCapture::onPanoramaStarted(int generation)
+{
+    if (generation != generation_)
+        return;
 
-            // 单像素三通道差值的平均
-            double d = (dr + dg + db) / 3.0;
-            diffSum += d;
-            ++sampleCount;
-        }
-    }
+    // 之后只抓整帧，预览从竖条切换为画布缩略图
+    qDebug() << "[LongShot] switched to panorama mode";
+    panorama_ = true;
+    needFullFrame_ = true;
+    previewStrip_.clear();
+    previewStripHeight_ = 0;
+    panelDirty_ = true;
+}
 
-    if (sampleCount == 0)
-        return false;
+void LongShotCapture::onPanoramaPreview(const QImage& thumbnail, int generation)
+{
+    if (generation != generation_ || thumbnail.isNull())
+        return;
 
-    double avgDiff = diffSum / sampleCount;
-    // 阈值：越大越“迟钝”，滚动一点才会认为有变化
-    return avgDiff > 10.0;
+    panoramaPreview_ = thumbnail;
+    panelDirty_ = true;
+    if (overlay_) overlay_->update();
 }
 
-void LongShotCapture::updatePreview()
+void LongShotCapture::onScrollActivity()
 {
-    if (segments_.isEmpty()) {
-        previewPixmap_ = QPixmap();
+    if (!active_)
         return;
-    }
 
-    int w = segments_.first().width();
-    int totalH = 0;
-    for (const QPixmap& p : segments_) {
-        totalH += p.height();
+    sampler_.onActivity();
+    // 下一帧还要等很久时重新计时；连续滚动时不要一直推迟
+    if (timer_.remainingTime() > sampler_.interval()) {
+        timer_.start(sampler_.interval());
+    }
+    else {
+        timer_.setInterval(sampler_.interval());
     }
+}
 
-    QImage img(w, totalH, QImage::Format_ARGB32);
-    img.fill(Qt::white);
+void LongShotCapture::drainWorker()
+{
+    // 队列是先进先出的，这个任务返回时之前投递的帧都已处理完；
+    // 顺便让拼接器交出还没输出的部分（一直没滚动时的整帧 / 吸底区域）
+    QMetaObject::invokeMethod(worker_, [w = worker_, g = generation_]() { w->finish(g); },
+        Qt::BlockingQueuedConnection);
+}
 
-    QPainter painter(&img);
-    int y = 0;
-    for (const QPixmap& p : segments_) {
-        painter.drawPixmap(0, y, p);
-        y += p.height();
+void LongShotCapture::rebuildPanelCache(const QSize& size)
+{
+    panelCache_ = QPixmap(size);
+    panelCache_.fill(Qt::transparent);
+    panelDirty_ = false;
+
+    if (size.isEmpty())
+        return;
+
+    if (panorama_) {
+        if (panoramaPreview_.isNull())
+            return;
+        // 缩略图缩放到面板内（保持比例），居中
+        const QSize fitted = panoramaPreview_.size().scaled(size, Qt::KeepAspectRatio);
+        const QRect dst(QPoint((size.width() - fitted.width()) / 2, (size.height() - fitted.height()) / 2), fitted);
+        QPainter p(&panelCache_);
+        p.setRenderHint(QPainter::SmoothPixmapTransform);
+        p.drawImage(dst, panoramaPreview_);
+        return;
     }
-    painter.end();
 
-    previewPixmap_ = QPixmap::fromImage(img);
+    if (previewStripHeight_ <= 0)
+        return;
+
+    // 整条缩放到面板内（保持比例），水平居中
+    const double scale = qMin(double(size.width()) / kPreviewStripWidth,
+        double(size.height()) / previewStripHeight_);
+    const double x = (size.width() - kPreviewStripWidth * scale) / 2.0;
+
+    QPainter p(&panelCache_);
+    p.setRenderHint(QPainter::SmoothPixmapTransform);
+    double y = 0;
+    for (const QImage& part : previewStrip_) {
+        const QRectF dst(x, y, kPreviewStripWidth * scale, part.height() * scale);
+        p.drawImage(dst, part);
+        y += dst.height();
+    }
 }
 
 void LongShotCapture::paintPreview(QPainter& painter, const QRect& widgetRect)
 {
-    if (!active_ || previewPixmap_.isNull())
+    if (!active_ || (previewStrip_.isEmpty() && panoramaPreview_.isNull()))
         return;
 
     painter.save();
@@ -328,18 +514,122 @@ void LongShotCapture::paintPreview(QPainter& painter, const QRect& widgetRect)
     painter.drawRoundedRect(panelRect, 8, 8);
 
     QRect inner = panelRect.adjusted(8, 8, -8, -8);
-    QPixmap scaled = previewPixmap_.scaled(
-        inner.size(),
-        Qt::KeepAspectRatio,
-        Qt::SmoothTransformation);
+    if (panelDirty_ || panelCache_.size() != inner.size()) {
+        rebuildPanelCache(inner.size());
+    }
+    painter.drawPixmap(inner.topLeft(), panelCache_);
 
-    QPoint topLeft = inner.topLeft();
-    topLeft.setX(inner.x() + (inner.width() - scaled.width()) / 2);
-    painter.drawPixmap(topLeft, scaled);
+    // 底部状态：实际抓帧速率 + 漏拍提示
+    QString status = QStringLiteral("%1 fps").arg(sampler_.rate(), 0, 'f', 1);
+    if (overlapWarnings_ > 0) {
+        status += QStringLiteral("  ·  可能漏拍 %1 处，请放慢滚动").arg(overlapWarnings_);
+    }
+    const QRect statusRect(inner.left(), inner.bottom() - 24, inner.width(), 24);
+    painter.setBrush(QColor(0, 0, 0, 180));
+    painter.drawRect(statusRect);
+    painter.setPen(overlapWarnings_ > 0 ? QColor(255, 200, 80) : QColor(230, 230, 230));
+    painter.drawText(statusRect, Qt::AlignCenter, status);
 
     painter.restore();
 }
 
+QImage LongShotCapture::composeResult() const
+{
+    if (worker_->isPanorama()) {
+        const QRect bounds = worker_->panorama().bounds();
+        if (bounds.width() > kMaxComposeHeight || bounds.height() > kMaxComposeHeight)
+            return QImage();
+        return worker_->panorama().copy(bounds);
+    }
+
+    const SegmentStore& segments = worker_->segments();
+    if (segments.isEmpty() || segments.totalHeight() > kMaxComposeHeight)
+        return QImage();
+
+    QImage img(segments.width(), int(segments.totalHeight()), QImage::Format_ARGB32);
+    img.fill(Qt::white);
+
+    // 逐段读回（已落盘的段从临时文件解压），画完即释放
+    QPainter painter(&img);
+    int y = 0;
+    for (int i = 0; i < segments.count(); ++i) {
+        painter.drawImage(0, y, segments.at(i));
+        y += segments.height(i);
+    }
+    painter.end();
+
+    return img;
+}
+
+bool LongShotCapture::exportTo(const QString& path, QString* savedPath, QString* error) const
+{
+    const SegmentStore& segments = worker_->segments();
+    const bool panorama = worker_->isPanorama();
+    const QRect bounds = worker_->panorama().bounds();
+    QString target = path;
+    const QString suffix = QFileInfo(path).suffix().toLower();
+
+    if (suffix != "png") {
+        const bool fits = panorama
+            ? bounds.width() <= kMaxComposeHeight && bounds.height() <= kMaxComposeHeight
+            : segments.totalHeight() <= kMaxComposeHeight;
+        if (fits) {
+            *savedPath = target;
+            if (!composeResult().save(target)) {
+                *error = QObject::tr("无法写入文件");
+                return false;
+            }
+            return true;
+        }
+        // JPEG / BMP 都装不下这么高的图，改存 PNG；同名 PNG 已存在时加序号，不覆盖用户没选过的文件
+        const QString base = QFileInfo(path).path() + "/" + QFileInfo(path).completeBaseName();
+        target = base + ".png";
+        for (int n = 1; QFileInfo::exists(target); ++n) {
+            target = QStringLiteral("%1-%2.png").arg(base).arg(n);
+        }
+        qDebug() << "[LongShot] export: result too tall for" << suffix << ", saving as" << target;
+    }
+    *savedPath = target;
+
+    StreamingPngWriter writer;
+    const bool opened = panorama
+        ? writer.open(target, bounds.width(), bounds.height())
+        : writer.open(target, segments.width(), segments.totalHeight());
+    if (!opened) {
+        qDebug() << "[LongShot] export failed:" << writer.errorString();
+        *error = writer.errorString();
+        return false;
+    }
+    if (panorama) {
+        // 按 tile 行切条读取画布并编码，空白处填白色
+        for (int y = bounds.top(); y <= bounds.bottom(); y += PanoramaCanvas::kTileSize) {
+            const int rows = qMin(PanoramaCanvas::kTileSize, bounds.bottom() - y + 1);
+            if (!writer.writeRows(worker_->panorama().copy(QRect(bounds.left(), y, bounds.width(), rows)))) {
+                qDebug() << "[LongShot] export failed:" << writer.errorString();
+                *error = writer.errorString();
+                return false;
+            }
+        }
+    }
+    else {
+        // 逐段读回并编码，内存里同时只有一段
+        for (int i = 0; i < segments.count(); ++i) {
+            if (!writer.writeRows(segments.at(i))) {
+                qDebug() << "[LongShot] export failed:" << writer.errorString();
+                *error = writer.errorString();
+                return false;
+            }
+        }
+    }
+    if (!writer.close()) {
+        qDebug() << "[LongShot] export failed:" << writer.errorString();
+        *error = writer.errorString();
+        return false;
+    }
+    qDebug() << "[LongShot] export: streamed" << writer.rowsWritten() << "rows to" << target;
+    return true;
+}
+
 bool LongShotCapture::handleKeyPress(QKeyEvent* event)
 {
     if (!active_)
@@ -356,33 +646,34 @@ bool LongShotCapture::handleKeyPress(QKeyEvent* event)
 bool LongShotCapture::handleWheel(QWheelEvent* event)
 {
     Q_UNUSED(event);
-    // QQ 模式：Overlay 鼠标穿透，真实窗口自己接收滚轮，我们不做任何事
+    // QQ 模式：Overlay 鼠标穿透，真实窗口自己接收滚轮，这里只用来加快采样
+    if (active_) {
+        onScrollActivity();
+    }
     return false;
 }
 
 void LongShotCapture::finishAndExport()
 {
-    // 停掉定时器 & 恢复样式
+    // 停掉定时器 & 恢复样式，等 worker 把已抓到的帧处理完
     stop();
+    drainWorker();
 
-    if (segments_.isEmpty()) {
+    const SegmentStore& segments = worker_->segments();
+    if (segments.isEmpty() && !worker_->isPanorama()) {
         if (overlay_) overlay_->close();
         return;
     }
 
-    if (previewPixmap_.isNull()) {
-        updatePreview();
+    // 1. 复制到剪贴板（太高的图剪贴板放不下，只提供保存）
+    const QImage result = composeResult();
+    if (!result.isNull()) {
+        QGuiApplication::clipboard()->setImage(result);
     }
-    if (previewPixmap_.isNull()) {
-        if (overlay_) overlay_->close();
-        return;
+    else {
+        qDebug() << "[LongShot] result size exceeds clipboard limit, skip copying";
     }
 
-    QPixmap result = previewPixmap_;
-
-    // 1. 复制到剪贴板
-    QGuiApplication::clipboard()->setPixmap(result);
-
     // 2. 另存为到本地
     const QString timestamp =
         QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss");
@@ -405,7 +696,18 @@ void LongShotCapture::finishAndExport()
     );
 
     if (!path.isEmpty()) {
-        result.save(path);
+        QString savedPath;
+        QString error;
+        if (!exportTo(path, &savedPath, &error)) {
+            QMessageBox::warning(overlay_, QObject::tr("保存长截图"),
+                QObject::tr("长截图保存失败：%1\n%2").arg(QDir::toNativeSeparators(savedPath), error));
+        }
+        else if (savedPath != path) {
+            // 用户选的格式装不下这么高的图，提示用户实际存到了哪里
+            QMessageBox::information(overlay_, QObject::tr("保存长截图"),
+                QObject::tr("长截图太高，%1 格式无法保存，已改存为 PNG：\n%2")
+                .arg(QFileInfo(path).suffix().toUpper(), QDir::toNativeSeparators(savedPath)));
+        }
     }
 
     if (overlay_) {
@@ -0,0 +1,116 @@
+#include "LongShotWorker.h"
+
+#include <QDebug>
+
+LongShotWorker::LongShotWorker(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void LongShotWorker::reset(int generation)
+{
+    generation_ = generation;
+    stitcher_.reset();
+    segments_.clear();
+    panorama_.clear();
+}
+
+void LongShotWorker::setMemoryBudget(qint64 bytes)
+{
+    segments_.setMemoryBudget(bytes);
+}
+
+void LongShotWorker::processFrame(const QImage& frame, int generation)
+{
+    if (generation != generation_ || frame.isNull()) {
+        emit frameProcessed(generation, false, 0.0, false);
+        return;
+    }
+
+    // 只追加新露出的行，已经拍到的内容不再重复
+    handleResult(stitcher_.push(frame), frame.size(), generation);
+}
+
+void LongShotWorker::processBand(const QImage& probe, const QImage& tail, int generation)
+{
+    if (generation != generation_) {
+        emit frameProcessed(generation, false, 0.0, false);
+        return;
+    }
+
+    const ScrollStitcher::Result stitched = stitcher_.pushBand(probe, tail);
+    if (stitched.needFullFrame) {
+        qDebug() << "[LongShot] worker: band grab could not be aligned, requesting full frame";
+        emit fullFrameRequested(generation);
+        // 内容在动，只是这次没能衔接，按滚过大半屏处理让采样加快
+        emit frameProcessed(generation, stitched.changed, stitched.changed ? 0.75 : 0.0, false);
+        return;
+    }
+    handleResult(stitched, stitcher_.lastFingerprint().size, generation);
+}
+
+void LongShotWorker::finish(int generation)
+{
+    if (generation != generation_) {
+        return;
+    }
+    appendBand(stitcher_.finish(), generation);
+}
+
+void LongShotWorker::handleResult(const ScrollStitcher::Result& stitched, const QSize& frameSize, int generation)
+{
+    if (!stitched.changed) {
+        qDebug() << "[LongShot] worker: frame same as last, segments size ="
+            << segments_.count();
+        emit frameProcessed(generation, false, 0.0, false);
+        return;
+    }
+
+    if (stitched.stickyChanged) {
+        const double h = qMax(1, frameSize.height());
+        emit stickyRegionsChanged(generation, stitcher_.headerRows() / h, stitcher_.footerRows() / h);
+    }
+    if (stitched.panoramaStarted) {
+        emit panoramaStarted(generation);
+    }
+
+    // 找不到重叠时整帧追加，按滚过整屏处理；全景模式按横竖两个方向里移动较多的那个算
+    const bool overlapLost = stitched.overlapLost;
+    const double motion = overlapLost
+        ? 1.0
+        : qMax(double(qAbs(stitched.match.offset)) / qMax(1, frameSize.height()),
+            double(qAbs(stitched.match.offsetX)) / qMax(1, frameSize.width()));
+
+    appendBand(stitched.band, generation);
+    if (!stitched.placements.isEmpty()) {
+        for (const ScrollStitcher::Result::Placement& placed : stitched.placements) {
+            panorama_.paste(placed.image, placed.pos);
+        }
+        qDebug() << "[LongShot] worker: panorama bounds =" << panorama_.bounds()
+            << ", tiles =" << panorama_.tileCount()
+            << ", memory =" << panorama_.memoryUsage() / 1024 << "KB";
+        emit panoramaPreviewReady(panorama_.thumbnail(QSize(kPreviewWidth, kPreviewWidth * 2)), generation);
+    }
+    emit frameProcessed(generation, true, motion, overlapLost);
+}
+
+void LongShotWorker::appendBand(const QImage& band, int generation)
+{
+    if (!band.isNull()) {
+        segments_.append(band);
+        qDebug() << "[LongShot] worker: appended" << band.height()
+            << "rows, segments size =" << segments_.count()
+            << ", memory =" << segments_.memoryUsage() / 1024 << "KB"
+            << ", disk =" << segments_.diskUsage() / 1024 << "KB";
+
+        // 按累计高度换算预览条带，避免每段各自取整造成的误差累积
+        const double scale = double(kPreviewWidth) / band.width();
+        const qint64 newHeight = segments_.totalHeight();
+        const qint64 oldHeight = newHeight - band.height();
+        const int scaledHeight = int(qRound64(newHeight * scale) - qRound64(oldHeight * scale));
+        if (scaledHeight > 0) {
+            emit previewBandReady(band.scaled(kPreviewWidth, scaledHeight,
+                Qt::IgnoreAspectRatio, Qt::SmoothTransformation), generation);
+        }
+    }
+}
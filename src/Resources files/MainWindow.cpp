@@ -1,9 +1,12 @@
 // MainWindow.cpp
 #include "MainWindow.h"
+#include "OcrResultCache.h"
+#include "OcrService.h"
 
 #include <QAction>
 #include <QApplication>
 #include <QIcon>
+#include <QStandardPaths>
 
 MainWindow::MainWindow(QWidget* parent)
     : QWidget(parent)
@@ -14,6 +17,8 @@ MainWindow::MainWindow(QWidget* parent)
     setWindowIcon(QIcon(":/icons/icons8-cut-64.png"));  
 
     createTrayIcon();
+    setupOcrCache();
+    startOcrWarmUp();
 }
 
 void MainWindow::createTrayIcon()
@@ -47,6 +52,32 @@ void MainWindow::createTrayIcon()
         });
 }
 
+void MainWindow::setupOcrCache()
+{
+    // Ĭֻڴ BYTE_SCREENSHOT_OCR_CACHE=disk дػĿ¼Ȼ
+    if (qEnvironmentVariable("BYTE_SCREENSHOT_OCR_CACHE") == "disk") {
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        OcrResultCache::instance().setStorageFile(dir + "/ocr-cache.dat");
+    }
+}
+
+void MainWindow::startOcrWarmUp()
+{
+    // Ĭ OCR λBYTE_SCREENSHOT_OCR_PROFILE=fast / balanced / accurateδʱΪ balanced
+    // ԤȵҲλģ
+    const QString profile = qEnvironmentVariable("BYTE_SCREENSHOT_OCR_PROFILE");
+    if (!profile.isEmpty()) {
+        OcrService::instance().setDefaultProfile(profile);
+    }
+
+    // Ѿúں̨ OCR ģͣһ OCR ٵģͼأ
+    //  BYTE_SCREENSHOT_OCR_WARMUP=0 ɹرգڴŻ OCR ʱ
+    if (qEnvironmentVariable("BYTE_SCREENSHOT_OCR_WARMUP") == "0") {
+        return;
+    }
+    OcrService::instance().warmUp();
+}
+
 void MainWindow::OnStartCapture()
 {
     // 1. Ƚһͼ
@@ -4,6 +4,9 @@
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QImage>
+#include <algorithm>
+#include <vector>
 
 MosaicTool::MosaicTool(QObject* parent) : QObject(parent) {
 }
@@ -13,38 +16,84 @@ void MosaicTool::applyEffect(QPixmap& pixmap, const QRect& area, int blockSize)
         return;
     }
 
-    QPainter painter(&pixmap);
-    QImage image = pixmap.toImage();
-
     // ͼΧ
     QRect effectiveArea = area.intersected(pixmap.rect());
+    if (effectiveArea.isEmpty()) return;
 
-    for (int y = effectiveArea.top(); y < effectiveArea.bottom(); y += blockSize) {
-        for (int x = effectiveArea.left(); x < effectiveArea.right(); x += blockSize) {
-            QRect blockRect(x, y, blockSize, blockSize);
-            blockRect = blockRect.intersected(effectiveArea);
-
-            if (blockRect.isEmpty()) continue;
-
-            // ƽɫ
-            int r = 0, g = 0, b = 0, a = 0;
-            int pixelCount = 0;
-
-            for (int by = blockRect.top(); by < blockRect.bottom(); ++by) {
-                for (int bx = blockRect.left(); bx < blockRect.right(); ++bx) {
-                    QRgb pixel = image.pixel(bx, by);
-                    r += qRed(pixel);
-                    g += qGreen(pixel);
-                    b += qBlue(pixel);
-                    a += qAlpha(pixel);
-                    pixelCount++;
+    // ֻתӰ򣬶 pixmap
+    QImage image = pixmap.copy(effectiveArea).toImage()
+        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    applyEffect(image, image.rect(), blockSize);
+
+    QPainter painter(&pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(effectiveArea.topLeft(), image);
+}
+
+void MosaicTool::applyEffect(QImage& image, const QRect& area, int blockSize) {
+    if (image.isNull() || area.isEmpty() || blockSize < 1) {
+        return;
+    }
+
+    QRect effectiveArea = area.intersected(image.rect());
+    if (effectiveArea.isEmpty()) return;
+
+    if (image.format() != QImage::Format_ARGB32_Premultiplied &&
+        image.format() != QImage::Format_ARGB32 &&
+        image.format() != QImage::Format_RGB32) {
+        image.convertTo(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    const int left = effectiveArea.left();
+    const int width = effectiveArea.width();
+    const int blocksX = (width + blockSize - 1) / blockSize;
+    const qsizetype stride = image.bytesPerLine();
+    uchar* bits = image.bits();
+
+    // ÿ 4 ͨۼӺͣ 50x5032 λ㹻
+    std::vector<quint32> sums(size_t(blocksX) * 4);
+
+    // ɨ裺Ȱѿÿһۼӵ飬ƽԭдء
+    // ÿֻдһΣ˳ڴ沼һ
+    for (int by = effectiveArea.top(); by <= effectiveArea.bottom(); by += blockSize) {
+        const int bh = qMin(blockSize, effectiveArea.bottom() - by + 1);
+        std::fill(sums.begin(), sums.end(), 0u);
+
+        for (int y = by; y < by + bh; ++y) {
+            const QRgb* line = reinterpret_cast<const QRgb*>(bits + y * stride) + left;
+            for (int bx = 0; bx < blocksX; ++bx) {
+                const int x0 = bx * blockSize;
+                const int x1 = qMin(width, x0 + blockSize);
+                quint32 a = 0, r = 0, g = 0, b = 0;
+                for (int x = x0; x < x1; ++x) {
+                    const QRgb p = line[x];
+                    a += qAlpha(p);
+                    r += qRed(p);
+                    g += qGreen(p);
+                    b += qBlue(p);
                 }
+                quint32* s = &sums[size_t(bx) * 4];
+                s[0] += a;
+                s[1] += r;
+                s[2] += g;
+                s[3] += b;
             }
+        }
 
-            if (pixelCount > 0) {
-                QColor avgColor(r / pixelCount, g / pixelCount,
-                    b / pixelCount, a / pixelCount);
-                painter.fillRect(blockRect, avgColor);
+        for (int bx = 0; bx < blocksX; ++bx) {
+            const int x0 = bx * blockSize;
+            const int x1 = qMin(width, x0 + blockSize);
+            const quint32 count = quint32((x1 - x0) * bh);
+            const quint32* s = &sums[size_t(bx) * 4];
+            // ƽԤ˸ʽ·ᳬ alpha
+            const QRgb avg = qRgba((s[1] + count / 2) / count,
+                (s[2] + count / 2) / count,
+                (s[3] + count / 2) / count,
+                (s[0] + count / 2) / count);
+
+            for (int y = by; y < by + bh; ++y) {
+                QRgb* line = reinterpret_cast<QRgb*>(bits + y * stride) + left;
+                std::fill(line + x0, line + x1, avg);
             }
         }
     }
@@ -0,0 +1,271 @@
+#include "OCR.h"
+#include "OcrImageBridge.h"
+#include "OcrResultCache.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <algorithm>
+#include <stdexcept>
+
+#include <args.h>
+#include <paddleocr.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+// PPOCR 持有 det / cls / rec 三个预测器；桥接缓冲跟着实例走，
+// 同一个 OcrEngine 同一时刻只会被一个线程使用（见 OcrService 的实例池）
+class PaddleOcrInternal : public PaddleOCR::PPOCR {
+public:
+    // PPOCR 构造时读的是 gflags 全局值，这里记下本实例的配置，之后别的实例改 flags 也不受影响
+    PaddleOcrInternal()
+        : use_cls(FLAGS_use_angle_cls), cls_thresh(FLAGS_cls_thresh) {
+    }
+
+    // 和 PPOCR::ocr 相同的 det -> cls -> rec 流程，拆开来是为了拿到每个阶段的耗时和阶段边界
+    std::vector<PaddleOCR::OCRPredictResult> run(const cv::Mat& img, OcrResult* result,
+        const OcrEngine::StageCallback& onStage) {
+        std::vector<PaddleOCR::OCRPredictResult> boxes;
+        QElapsedTimer timer;
+        timer.start();
+        Notify(onStage, OcrEngine::Stage::kDetect);
+        det(img, boxes);   // 结果已按阅读顺序排好
+        result->detMs = timer.restart();
+
+        std::vector<cv::Mat> crops;
+        crops.reserve(boxes.size());
+        for (const PaddleOCR::OCRPredictResult& box : boxes) {
+            crops.push_back(PaddleOCR::Utility::GetRotateCropImage(img, box.box));
+        }
+
+        if (use_cls && !crops.empty()) {
+            Notify(onStage, OcrEngine::Stage::kClassify);
+            cls(crops, boxes);
+            for (size_t i = 0; i < crops.size(); ++i) {
+                if (boxes[i].cls_label % 2 == 1 && boxes[i].cls_score > cls_thresh) {
+                    cv::rotate(crops[i], crops[i], cv::ROTATE_180);
+                }
+            }
+        }
+        result->clsMs = timer.restart();
+
+        if (!crops.empty()) {
+            Notify(onStage, OcrEngine::Stage::kRecognize);
+            rec(crops, boxes);
+        }
+        result->recMs = timer.elapsed();
+        return boxes;
+    }
+
+    // 小字号在整图尺度下经常识别成乱码：对置信度低的行从原图重新裁剪、四周留白后放大，
+    // 只跑识别阶段。所有待重识的行一次交给 rec()，由它按 batch 并行推理
+    void refine(const cv::Mat& img, std::vector<PaddleOCR::OCRPredictResult>& boxes,
+        float threshold, OcrResult* result, const OcrEngine::StageCallback& onStage) {
+        QElapsedTimer timer;
+        timer.start();
+
+        std::vector<size_t> picked;
+        std::vector<cv::Mat> crops;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].score >= threshold) {
+                continue;
+            }
+            cv::Mat crop = PaddleOCR::Utility::GetRotateCropImage(img, boxes[i].box);
+            if (crop.empty()) {
+                continue;
+            }
+            // 和第一遍一样，方向分类判为倒置的行先转正
+            if (use_cls && boxes[i].cls_label % 2 == 1 && boxes[i].cls_score > cls_thresh) {
+                cv::rotate(crop, crop, cv::ROTATE_180);
+            }
+            // 检测框贴着笔画，补一圈边缘像素再放大，避免首尾字符被截
+            const int pad = std::max(2, crop.rows / 8);
+            cv::copyMakeBorder(crop, crop, pad, pad, pad, pad, cv::BORDER_REPLICATE);
+            const double scale = crop.rows < 24 ? 3.0 : 2.0;
+            cv::resize(crop, crop, cv::Size(), scale, scale, cv::INTER_CUBIC);
+            crops.push_back(crop);
+            picked.push_back(i);
+        }
+        if (crops.empty()) {
+            return;
+        }
+
+        Notify(onStage, OcrEngine::Stage::kRefine);
+        std::vector<PaddleOCR::OCRPredictResult> again(crops.size());
+        rec(crops, again);
+        for (size_t k = 0; k < picked.size(); ++k) {
+            PaddleOCR::OCRPredictResult& old = boxes[picked[k]];
+            if (!again[k].text.empty() && again[k].score > old.score) {
+                old.text = again[k].text;
+                old.score = again[k].score;
+                ++result->refinedLines;
+            }
+        }
+        result->refineMs = timer.elapsed();
+    }
+
+    static void Notify(const OcrEngine::StageCallback& onStage, OcrEngine::Stage stage) {
+        if (onStage) {
+            onStage(stage);
+        }
+    }
+
+    OcrImageBridge bridge;
+    const bool use_cls;
+    const double cls_thresh;
+};
+
+namespace {
+
+    // PPOCR 的构造函数从 gflags 全局变量里读配置，多个实例并发初始化时要串行
+    QMutex& FlagsMutex()
+    {
+        static QMutex mutex;
+        return mutex;
+    }
+
+    QString DefaultModelDir()
+    {
+        return QCoreApplication::applicationDirPath() + "/models";
+    }
+
+} // namespace
+
+OcrEngine::OcrEngine(QObject* parent)
+    : QObject(parent) {
+}
+
+OcrEngine::~OcrEngine() {
+    release();
+}
+
+bool OcrEngine::init(const QString& modelDir) {
+    if (is_initialized_) {
+        return true;
+    }
+
+    const QDir dir(modelDir);
+    // 档位指定的模型不存在时回退到默认模型，只缺轻量 / 服务端模型也能用
+    auto pick = [&dir](const QString& preferred, const QString& fallback) {
+        const QString path = dir.filePath(preferred);
+        return QFileInfo::exists(path) ? path : dir.filePath(fallback);
+    };
+    const QString det = pick(profile_.detModel, profile_.fallbackDet);
+    const QString rec = pick(profile_.recModel, profile_.fallbackRec);
+    const QString cls = dir.filePath("cls");
+    const QString dict = dir.filePath("ppocr_keys_v1.txt");
+    for (const QString& path : { det, rec, dict }) {
+        if (!QFileInfo::exists(path)) {
+            qWarning() << "[OCR] missing model file:" << path;
+            return false;
+        }
+    }
+
+    QMutexLocker lock(&FlagsMutex());
+    FLAGS_det_model_dir = QDir::toNativeSeparators(det).toStdString();
+    FLAGS_rec_model_dir = QDir::toNativeSeparators(rec).toStdString();
+    FLAGS_rec_char_dict_path = QDir::toNativeSeparators(dict).toStdString();
+    FLAGS_use_angle_cls = profile_.useCls && QFileInfo::exists(cls);
+    if (FLAGS_use_angle_cls) {
+        FLAGS_cls_model_dir = QDir::toNativeSeparators(cls).toStdString();
+    }
+    FLAGS_enable_mkldnn = true;
+    FLAGS_cpu_threads = profile_.cpuThreads;
+    FLAGS_limit_type = "max";
+    FLAGS_limit_side_len = profile_.limitSideLen;
+    FLAGS_rec_batch_num = profile_.recBatch;
+
+    try {
+        internal_ = std::make_unique<PaddleOcrInternal>();
+    }
+    catch (const std::exception& e) {
+        qWarning() << "[OCR] failed to create predictors:" << e.what();
+        internal_.reset();
+        return false;
+    }
+    is_initialized_ = true;
+    qDebug() << "[OCR] profile" << profile_.name << "loaded: det" << det << "rec" << rec
+        << "cls" << bool(FLAGS_use_angle_cls) << "threads" << profile_.cpuThreads;
+    return true;
+}
+
+void OcrEngine::setProfile(const OcrProfile& profile) {
+    if (is_initialized_) {
+        qWarning() << "[OCR] setProfile ignored, models already loaded for" << profile_.name;
+        return;
+    }
+    profile_ = profile;
+    refine_threshold_ = profile.refineThreshold;
+}
+
+QString OcrEngine::detectText(const QImage& image, bool useCache) {
+    return recognize(image, useCache).text();
+}
+
+OcrResult OcrEngine::recognize(const QImage& image, bool useCache, const StageCallback& onStage) {
+    OcrResult result;
+    result.imageSize = image.size();
+    if (image.isNull()) {
+        return result;
+    }
+
+    QByteArray key;
+    if (useCache) {
+        key = OcrResultCache::keyFor(image, profile_.name);
+        if (OcrResultCache::instance().lookup(key, &result)) {
+            result.fromCache = true;
+            return result;
+        }
+    }
+
+    // 模型懒加载：第一次识别时才初始化
+    if (!is_initialized_) {
+        if (onStage) {
+            onStage(Stage::kLoadModels);
+        }
+        if (!init(DefaultModelDir())) {
+            throw std::runtime_error("OCR models not found in " + DefaultModelDir().toStdString());
+        }
+    }
+
+    QElapsedTimer total;
+    total.start();
+    const cv::Mat bgr = internal_->bridge.toBgr(image);
+    if (bgr.empty()) {
+        return result;
+    }
+
+    std::vector<PaddleOCR::OCRPredictResult> boxes = internal_->run(bgr, &result, onStage);
+    if (refine_threshold_ > 0) {
+        internal_->refine(bgr, boxes, refine_threshold_, &result, onStage);
+    }
+    for (const PaddleOCR::OCRPredictResult& r : boxes) {
+        if (r.text.empty()) {
+            continue;
+        }
+        OcrLine line;
+        for (const std::vector<int>& pt : r.box) {
+            if (pt.size() >= 2) {
+                line.polygon << QPoint(pt[0], pt[1]);
+            }
+        }
+        line.text = QString::fromStdString(r.text);
+        line.confidence = r.score;
+        result.lines.push_back(line);
+    }
+    result.totalMs = total.elapsed();
+
+    if (useCache) {
+        OcrResultCache::instance().insert(key, result);
+    }
+    return result;
+}
+
+void OcrEngine::release() {
+    internal_.reset();
+    is_initialized_ = false;
+}
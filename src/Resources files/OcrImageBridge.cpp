@@ -0,0 +1,60 @@
+#include "OcrImageBridge.h"
+
+#include <opencv2/imgproc.hpp>
+
+cv::Mat OcrImageBridge::wrap(const QImage& image)
+{
+    int type = -1;
+    switch (image.format()) {
+    case QImage::Format_BGR888:
+    case QImage::Format_RGB888:
+        type = CV_8UC3;
+        break;
+    // 小端机器上 32 位格式在内存里就是 B G R A
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        type = CV_8UC4;
+        break;
+    case QImage::Format_Grayscale8:
+        type = CV_8UC1;
+        break;
+    default:
+        return cv::Mat();
+    }
+    // PaddleOCR 只读输入（缩放 / 裁剪都会生成新 Mat），去掉 const 是安全的
+    return cv::Mat(image.height(), image.width(), type,
+        const_cast<uchar*>(image.constBits()), size_t(image.bytesPerLine()));
+}
+
+cv::Mat OcrImageBridge::toBgr(const QImage& image)
+{
+    if (image.isNull()) {
+        return cv::Mat();
+    }
+
+    cv::Mat view = wrap(image);
+    if (view.empty()) {
+        converted_ = image.convertToFormat(QImage::Format_RGB32);
+        ++stats_.qtConversions;
+        view = wrap(converted_);
+    }
+
+    if (image.format() == QImage::Format_BGR888) {
+        // 包装过程中 QImage 不能发生 detach，否则就不是零拷贝了
+        Q_ASSERT(view.data == image.constBits());
+        ++stats_.zeroCopy;
+        return view;
+    }
+
+    const int code = view.channels() == 4 ? cv::COLOR_BGRA2BGR
+        : view.channels() == 1 ? cv::COLOR_GRAY2BGR
+        : cv::COLOR_RGB2BGR;
+    if (buffer_.rows != view.rows || buffer_.cols != view.cols || buffer_.type() != CV_8UC3) {
+        ++stats_.bufferReallocs;
+    }
+    // 目标尺寸 / 类型一致时 cvtColor 复用 buffer_ 的内存
+    cv::cvtColor(view, buffer_, code);
+    ++stats_.converted;
+    return buffer_;
+}
@@ -0,0 +1,62 @@
+#include "OcrProfile.h"
+
+#include <QThread>
+
+OcrProfile OcrProfile::fast()
+{
+    OcrProfile p;
+    p.name = "fast";
+    p.detModel = "det_lite";
+    p.recModel = "rec_lite";
+    p.useCls = false;
+    p.cpuThreads = qMax(1, QThread::idealThreadCount() / 4);
+    p.limitSideLen = 736;
+    p.recBatch = 8;
+    p.refineThreshold = 0.0f;
+    return p;
+}
+
+OcrProfile OcrProfile::balanced()
+{
+    OcrProfile p;
+    p.name = "balanced";
+    p.cpuThreads = qMax(2, QThread::idealThreadCount() / 2);
+    return p;
+}
+
+OcrProfile OcrProfile::accurate()
+{
+    OcrProfile p;
+    p.name = "accurate";
+    p.detModel = "det_server";
+    p.recModel = "rec_server";
+    p.useCls = true;
+    p.cpuThreads = qMax(2, QThread::idealThreadCount());
+    p.limitSideLen = 1920;
+    p.recBatch = 6;
+    p.refineThreshold = 0.92f;
+    return p;
+}
+
+OcrProfile OcrProfile::sizedForPool(int engines) const
+{
+    OcrProfile p = *this;
+    p.cpuThreads = qMin(cpuThreads, qMax(1, QThread::idealThreadCount() / qMax(1, engines)));
+    return p;
+}
+
+QStringList OcrProfile::names()
+{
+    return { "fast", "balanced", "accurate" };
+}
+
+OcrProfile OcrProfile::byName(const QString& name)
+{
+    if (name == "fast") {
+        return fast();
+    }
+    if (name == "accurate") {
+        return accurate();
+    }
+    return balanced();
+}
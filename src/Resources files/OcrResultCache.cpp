@@ -0,0 +1,304 @@
+#include "OcrResultCache.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QTimer>
+#include <cstring>
+
+namespace {
+
+    constexpr quint32 kStorageMagic = 0x4F435243;   // "OCRC"
+    constexpr quint32 kStorageVersion = 2;
+    // 写入后等这么久再保存，一次长截图切片 / 连续 OCR 产生的多次写入只落盘一次
+    constexpr int kSaveDelayMs = 2000;
+
+    using Snapshot = QList<QPair<QByteArray, OcrResult>>;
+
+    // 两路 64 位乘法哈希，按 8 字节一个字处理；结果跨进程稳定，落盘后还能命中
+    struct PixelHash {
+        quint64 a = 0x9E3779B97F4A7C15ull;
+        quint64 b = 0xC2B2AE3D27D4EB4Full;
+
+        void mix(quint64 w)
+        {
+            a = (a ^ w) * 0xFF51AFD7ED558CCDull;
+            a ^= a >> 29;
+            b = (b ^ (w + 0x632BE59BD9B4E019ull)) * 0xC4CEB9FE1A85EC53ull;
+            b ^= b >> 31;
+        }
+
+        void add(const uchar* data, qsizetype len)
+        {
+            qsizetype i = 0;
+            for (; i + 8 <= len; i += 8) {
+                quint64 w;
+                std::memcpy(&w, data + i, 8);
+                mix(w);
+            }
+            if (i < len) {
+                quint64 w = 0;
+                std::memcpy(&w, data + i, size_t(len - i));
+                mix(w ^ (quint64(len - i) << 56));
+            }
+        }
+    };
+
+    qint64 ResultBytes(const OcrResult& result)
+    {
+        qint64 bytes = 0;
+        for (const OcrLine& line : result.lines) {
+            bytes += qint64(line.text.size()) * qint64(sizeof(QChar))
+                + qint64(line.polygon.size()) * qint64(sizeof(QPoint)) + qint64(sizeof(OcrLine));
+        }
+        return bytes;
+    }
+
+    // 落盘只存识别内容，耗时与 fromCache 标记不存
+    void WriteResult(QDataStream& out, const OcrResult& result)
+    {
+        out << result.imageSize << qint32(result.lines.size());
+        for (const OcrLine& line : result.lines) {
+            out << line.polygon << line.text << line.confidence;
+        }
+    }
+
+    bool ReadResult(QDataStream& in, OcrResult* result)
+    {
+        qint32 n = 0;
+        in >> result->imageSize >> n;
+        if (n < 0) {
+            return false;
+        }
+        result->lines.resize(n);
+        for (OcrLine& line : result->lines) {
+            in >> line.polygon >> line.text >> line.confidence;
+        }
+        return in.status() == QDataStream::Ok;
+    }
+
+    // 在锁外执行：snapshot 按从旧到新的 LRU 顺序排列
+    void WriteFile(const QString& path, const Snapshot& snapshot)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "[OcrCache] cannot write" << path;
+            return;
+        }
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << kStorageMagic << kStorageVersion << qint32(snapshot.size());
+        for (const auto& entry : snapshot) {
+            out << entry.first;
+            WriteResult(out, entry.second);
+        }
+        file.commit();
+    }
+
+} // namespace
+
+OcrResultCache& OcrResultCache::instance()
+{
+    static OcrResultCache cache;
+    return cache;
+}
+
+QByteArray OcrResultCache::keyFor(const QImage& image)
+{
+    PixelHash h;
+    h.mix((quint64(quint32(image.width())) << 32) | quint32(image.height()));
+    h.mix(quint64(image.format()));
+    // 只哈希每行的有效像素，行尾填充的内容不确定
+    const qsizetype rowBytes = (qsizetype(image.width()) * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y) {
+        h.add(image.constScanLine(y), rowBytes);
+    }
+    QByteArray key(16, Qt::Uninitialized);
+    std::memcpy(key.data(), &h.a, 8);
+    std::memcpy(key.data() + 8, &h.b, 8);
+    return key.toHex();
+}
+
+QByteArray OcrResultCache::keyFor(const QImage& image, const QString& profile)
+{
+    return keyFor(image) + ':' + profile.toUtf8();
+}
+
+bool OcrResultCache::lookup(const QByteArray& key, OcrResult* result)
+{
+    QMutexLocker lock(&mutex_);
+    auto it = entries_.constFind(key);
+    if (it == entries_.constEnd()) {
+        return false;
+    }
+    *result = it->result;
+    order_.removeOne(key);
+    order_.push_back(key);
+    return true;
+}
+
+void OcrResultCache::insert(const QByteArray& key, const OcrResult& result)
+{
+    QMutexLocker lock(&mutex_);
+    const qint64 bytes = ResultBytes(result);
+    if (bytes > max_bytes_) {
+        return;
+    }
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        bytes_ -= it->bytes;
+        order_.removeOne(key);
+    }
+    entries_.insert(key, Entry{ result, bytes });
+    order_.push_back(key);
+    bytes_ += bytes;
+    evictLocked();
+
+    if (!storage_file_.isEmpty()) {
+        dirty_ = true;
+        scheduleSaveLocked();
+    }
+}
+
+void OcrResultCache::clear()
+{
+    // 先等正在进行的保存结束，免得删掉文件后又被旧快照写回来
+    QMutexLocker saveLock(&save_mutex_);
+    QMutexLocker lock(&mutex_);
+    entries_.clear();
+    order_.clear();
+    bytes_ = 0;
+    dirty_ = false;
+    if (!storage_file_.isEmpty()) {
+        QFile::remove(storage_file_);
+    }
+}
+
+void OcrResultCache::setLimits(int maxEntries, qint64 maxBytes)
+{
+    QMutexLocker lock(&mutex_);
+    max_entries_ = qMax(1, maxEntries);
+    max_bytes_ = qMax<qint64>(1, maxBytes);
+    evictLocked();
+}
+
+void OcrResultCache::setStorageFile(const QString& path)
+{
+    // 换文件前把旧文件该写的写完
+    flush();
+    QMutexLocker saveLock(&save_mutex_);
+    QMutexLocker lock(&mutex_);
+    storage_file_ = path;
+    dirty_ = false;
+    if (storage_file_.isEmpty()) {
+        return;
+    }
+    loadLocked();
+    if (!quit_hooked_ && QCoreApplication::instance()) {
+        quit_hooked_ = true;
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+            QCoreApplication::instance(), [this]() { flush(); });
+    }
+}
+
+void OcrResultCache::flush()
+{
+    QMutexLocker saveLock(&save_mutex_);
+    QString path;
+    Snapshot snapshot;
+    {
+        // 只在锁内复制条目（OcrResult 是隐式共享的，复制很便宜），序列化和写文件都在锁外
+        QMutexLocker lock(&mutex_);
+        save_scheduled_ = false;
+        if (!dirty_ || storage_file_.isEmpty()) {
+            return;
+        }
+        dirty_ = false;
+        path = storage_file_;
+        snapshot.reserve(order_.size());
+        for (const QByteArray& key : order_) {
+            snapshot.push_back(qMakePair(key, entries_.value(key).result));
+        }
+    }
+    WriteFile(path, snapshot);
+}
+
+int OcrResultCache::count() const
+{
+    QMutexLocker lock(&mutex_);
+    return entries_.size();
+}
+
+qint64 OcrResultCache::bytes() const
+{
+    QMutexLocker lock(&mutex_);
+    return bytes_;
+}
+
+void OcrResultCache::evictLocked()
+{
+    while (!order_.isEmpty() && (order_.size() > max_entries_ || bytes_ > max_bytes_)) {
+        const QByteArray key = order_.takeFirst();
+        bytes_ -= entries_.take(key).bytes;
+    }
+}
+
+void OcrResultCache::loadLocked()
+{
+    QFile file(storage_file_);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 n = 0;
+    in >> magic >> version >> n;
+    if (magic != kStorageMagic || version != kStorageVersion || n < 0) {
+        qWarning() << "[OcrCache] ignoring incompatible cache file" << storage_file_;
+        return;
+    }
+    // 文件里按从旧到新的顺序存，读回后 LRU 顺序不变
+    for (qint32 i = 0; i < n && in.status() == QDataStream::Ok; ++i) {
+        QByteArray key;
+        OcrResult result;
+        in >> key;
+        if (!ReadResult(in, &result) || entries_.contains(key)) {
+            continue;
+        }
+        const qint64 bytes = ResultBytes(result);
+        entries_.insert(key, Entry{ result, bytes });
+        order_.push_back(key);
+        bytes_ += bytes;
+    }
+    evictLocked();
+    qDebug() << "[OcrCache] loaded" << entries_.size() << "entries from" << storage_file_;
+}
+
+void OcrResultCache::scheduleSaveLocked()
+{
+    if (save_scheduled_) {
+        return;
+    }
+    QCoreApplication* app = QCoreApplication::instance();
+    if (!app) {
+        // 没有事件循环（离线工具）时不排队，由调用方 flush()
+        return;
+    }
+    save_scheduled_ = true;
+    // insert 可能在 OCR worker 线程里调用，计时器放到主线程；到点后在线程池里写文件，不占用 GUI 线程
+    QMetaObject::invokeMethod(app, [this, app]() {
+        QTimer::singleShot(kSaveDelayMs, app, [this]() {
+            QThreadPool::globalInstance()->start([this]() { flush(); });
+            });
+        }, Qt::QueuedConnection);
+}
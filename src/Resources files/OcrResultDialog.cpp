@@ -5,11 +5,97 @@
 #include <QLabel>
 #include <QTextEdit>
 #include <QPushButton>
+#include <QProgressBar>
 #include <QClipboard>
 #include <QApplication>
 #include <QTimer>
 #include <QWheelEvent>
 #include <QFrame>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QTextBlock>
+#include <QSet>
+#include <functional>
+
+// Image pane: paints only the exposed part at the current zoom and overlays
+// the detected text boxes; highlighted boxes get a translucent fill
+class OcrImageView : public QWidget {
+public:
+    OcrImageView(const QPixmap& pixmap, QWidget* parent)
+        : QWidget(parent), pixmap_(pixmap) {
+        setCursor(Qt::ArrowCursor);
+    }
+
+    void SetBoxes(const QVector<QPolygon>& boxes) {
+        boxes_ = boxes;
+        highlighted_.clear();
+        update();
+    }
+
+    void SetHighlighted(const QSet<int>& indices) {
+        if (indices == highlighted_) return;
+        highlighted_ = indices;
+        update();
+    }
+
+    // Image coordinates -> widget coordinates
+    QRect MapToView(const QRect& image_rect) const {
+        const double s = Scale();
+        return QRectF(image_rect.x() * s, image_rect.y() * s,
+            image_rect.width() * s, image_rect.height() * s).toAlignedRect();
+    }
+
+    std::function<void(int)> box_clicked;
+
+protected:
+    void paintEvent(QPaintEvent* event) override {
+        if (pixmap_.isNull()) return;
+        QPainter p(this);
+        p.setRenderHint(QPainter::SmoothPixmapTransform);
+
+        const double s = Scale();
+        const QRect exposed = event->rect();
+        const QRectF src(exposed.x() / s, exposed.y() / s, exposed.width() / s, exposed.height() / s);
+        p.drawPixmap(QRectF(exposed), pixmap_, src);
+
+        if (boxes_.isEmpty()) return;
+        p.setRenderHint(QPainter::Antialiasing);
+        p.scale(s, s);
+        QPen pen(QColor(92, 157, 237, 200));
+        pen.setCosmetic(true);
+        pen.setWidth(1);
+        p.setPen(pen);
+        const QRect visible = src.toAlignedRect();
+        for (int i = 0; i < boxes_.size(); ++i) {
+            if (!boxes_[i].boundingRect().intersects(visible)) continue;
+            p.setBrush(highlighted_.contains(i) ? QColor(92, 157, 237, 90) : QColor(Qt::transparent));
+            p.drawPolygon(boxes_[i]);
+        }
+    }
+
+    void mousePressEvent(QMouseEvent* event) override {
+        const double s = Scale();
+        const QPoint pt(qRound(event->position().x() / s), qRound(event->position().y() / s));
+        for (int i = 0; i < boxes_.size(); ++i) {
+            if (boxes_[i].containsPoint(pt, Qt::OddEvenFill)) {
+                if (box_clicked) box_clicked(i);
+                event->accept();
+                return;
+            }
+        }
+        QWidget::mousePressEvent(event);
+    }
+
+private:
+    double Scale() const {
+        return pixmap_.width() > 0 ? double(width()) / pixmap_.width() : 1.0;
+    }
+
+    QPixmap pixmap_;
+    QVector<QPolygon> boxes_;
+    QSet<int> highlighted_;
+};
 
 OcrResultDialog::OcrResultDialog(const QPixmap& pixmap, const QString& text, QWidget* parent)
     : QDialog(parent), pixmap_(pixmap), text_(text) {
@@ -60,6 +146,16 @@ OcrResultDialog::OcrResultDialog(const QPixmap& pixmap, const QString& text, QWi
         "  background-color: #2b2d2f;"
         "  color: #777777;"
         "}"
+        "QProgressBar {"
+        "  background-color: #3c3f41;"
+        "  color: #f0f0f0;"
+        "  border: 1px solid #555555;"
+        "  border-radius: 4px;"
+        "  text-align: center;"
+        "}"
+        "QProgressBar::chunk {"
+        "  background-color: #5c9ded;"
+        "}"
     );
 
     SetupUi();
@@ -80,11 +176,10 @@ void OcrResultDialog::SetupUi() {
     scroll_area_->setAlignment(Qt::AlignCenter);
     scroll_area_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
-    image_label_ = new QLabel(scroll_area_);
-    image_label_->setPixmap(pixmap_);
-    image_label_->setAlignment(Qt::AlignCenter);
-    image_label_->setScaledContents(true);
-    scroll_area_->setWidget(image_label_);
+    image_view_ = new OcrImageView(pixmap_, scroll_area_);
+    image_view_->resize(pixmap_.size());
+    image_view_->box_clicked = [this](int index) { SelectLine(index); };
+    scroll_area_->setWidget(image_view_);
 
     center_layout->addWidget(scroll_area_, 1);
 
@@ -94,6 +189,8 @@ void OcrResultDialog::SetupUi() {
     text_edit_->setPlainText(text_);
     text_edit_->setFont(QFont("Consolas", 10));
     text_edit_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    connect(text_edit_, &QTextEdit::selectionChanged, this, &OcrResultDialog::OnTextSelectionChanged);
+    connect(text_edit_, &QTextEdit::cursorPositionChanged, this, &OcrResultDialog::OnTextSelectionChanged);
 
     center_layout->addWidget(text_edit_, 1);
 
@@ -108,6 +205,14 @@ void OcrResultDialog::SetupUi() {
     // Bottom area: Buttons
     auto* btn_layout = new QHBoxLayout();
     btn_layout->setSpacing(10);
+
+    // Recognition progress, hidden until the OCR service reports
+    progress_bar_ = new QProgressBar(this);
+    progress_bar_->setRange(0, 100);
+    progress_bar_->setFixedWidth(240);
+    progress_bar_->setVisible(false);
+    btn_layout->addWidget(progress_bar_);
+
     btn_layout->addStretch();
 
     btn_copy_ = new QPushButton(tr("Copy"), this);
@@ -165,17 +270,91 @@ void OcrResultDialog::wheelEvent(QWheelEvent* event) {
 }
 
 void OcrResultDialog::UpdateImageScale() {
-    if (image_label_ && !pixmap_.isNull()) {
+    if (image_view_ && !pixmap_.isNull()) {
         QSize new_size = pixmap_.size() * scale_factor_;
-        image_label_->resize(new_size);
+        image_view_->resize(new_size);
     }
 }
 
 void OcrResultDialog::SetResultText(const QString& text) {
+    // Plain text carries no geometry, so any previous boxes no longer apply
+    result_ = OcrResult();
+    if (image_view_) {
+        image_view_->SetBoxes({});
+    }
     text_ = text;
     if (text_edit_) {
         text_edit_->setPlainText(text_);
     }
+    if (progress_bar_) {
+        progress_bar_->setVisible(false);
+    }
+}
+
+void OcrResultDialog::SetResult(const OcrResult& result) {
+    SetResultText(result.text());
+    result_ = result;
+
+    QVector<QPolygon> boxes;
+    boxes.reserve(result_.lines.size());
+    for (const OcrLine& line : result_.lines) {
+        boxes.push_back(line.polygon);
+    }
+    if (image_view_) {
+        image_view_->SetBoxes(boxes);
+    }
+
+    setWindowTitle(result_.fromCache
+        ? QString("OCR Result - %1 lines (cached)").arg(result_.lines.size())
+        : QString("OCR Result - %1 lines, det %2 ms / cls %3 ms / rec %4 ms / refine %5 ms")
+            .arg(result_.lines.size()).arg(result_.detMs).arg(result_.clsMs).arg(result_.recMs)
+            .arg(result_.refineMs));
+}
+
+void OcrResultDialog::OnTextSelectionChanged() {
+    if (!text_edit_ || !image_view_ || result_.lines.isEmpty()) {
+        return;
+    }
+
+    // Map the selected text lines (or the cursor line) back to their boxes
+    const QTextCursor cursor = text_edit_->textCursor();
+    const QTextDocument* doc = text_edit_->document();
+    const int first = doc->findBlock(cursor.selectionStart()).blockNumber();
+    const int last = doc->findBlock(cursor.selectionEnd()).blockNumber();
+
+    QSet<int> indices;
+    for (int i = qMax(0, first); i <= last && i < result_.lines.size(); ++i) {
+        indices.insert(i);
+    }
+    image_view_->SetHighlighted(indices);
+
+    if (first >= 0 && first < result_.lines.size()) {
+        const QRect box = image_view_->MapToView(result_.lines[first].boundingRect());
+        scroll_area_->ensureVisible(box.center().x(), box.center().y(), box.width() / 2 + 20, box.height() / 2 + 20);
+    }
+}
+
+void OcrResultDialog::SelectLine(int index) {
+    if (!text_edit_ || index < 0 || index >= result_.lines.size()) {
+        return;
+    }
+    const QTextBlock block = text_edit_->document()->findBlockByNumber(index);
+    if (!block.isValid()) {
+        return;
+    }
+    QTextCursor cursor(block);
+    cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+    text_edit_->setTextCursor(cursor);
+    text_edit_->ensureCursorVisible();
+}
+
+void OcrResultDialog::SetProgress(int percent, const QString& stage) {
+    if (!progress_bar_) {
+        return;
+    }
+    progress_bar_->setValue(qBound(0, percent, 100));
+    progress_bar_->setFormat(stage.isEmpty() ? QString("%p%") : stage + " %p%");
+    progress_bar_->setVisible(percent < 100);
 }
 
 void OcrResultDialog::AppendResultText(const QString& text) {
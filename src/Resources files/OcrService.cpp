@@ -0,0 +1,356 @@
+#include "OcrService.h"
+#include "OCR.h"
+#include "OcrResultCache.h"
+#include "OcrTiler.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFont>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QSemaphore>
+#include <exception>
+
+namespace {
+
+    // 切片直接引用原图的扫描行，不拷贝像素；原图在所有切片识别完之前一直有效
+    QImage TileView(const QImage& image, const QRect& rect) {
+        if (image.depth() < 8 || image.colorCount() > 0) {
+            return image.copy(rect);
+        }
+        const uchar* first = image.constBits()
+            + qsizetype(rect.top()) * image.bytesPerLine()
+            + qsizetype(rect.left()) * (image.depth() / 8);
+        return QImage(first, rect.width(), rect.height(), image.bytesPerLine(), image.format());
+    }
+
+} // namespace
+
+OcrTask::OcrTask(QObject* parent)
+    : QObject(parent), canceled_(std::make_shared<std::atomic_bool>(false)) {
+}
+
+OcrTask::~OcrTask() {
+    // 句柄没了，结果也就没人要了
+    cancel();
+}
+
+void OcrTask::cancel() {
+    canceled_->store(true);
+}
+
+bool OcrTask::isCanceled() const {
+    return canceled_->load();
+}
+
+OcrService& OcrService::instance() {
+    static OcrService service;
+    return service;
+}
+
+OcrService::OcrService(QObject* parent)
+    : QObject(parent) {
+    // 并行切片数按核数取，上限 4：每多一个实例就多一份模型内存；
+    // Paddle 自己在单次推理里也用多线程，所以每个实例的线程数再按实例数均分
+    setMaxEngines(QThread::idealThreadCount() / 2);
+
+    thread_.setObjectName("OcrWorker");
+    context_ = new QObject();
+    context_->moveToThread(&thread_);
+    connect(&thread_, &QThread::finished, context_, &QObject::deleteLater);
+    thread_.start();
+}
+
+OcrService::~OcrService() {
+    // 正在进行的推理无法打断，只能等它结束；排队中的请求随事件循环退出一起丢弃
+    thread_.quit();
+    thread_.wait();
+    tile_pool_.waitForDone();
+}
+
+void OcrService::setMaxEngines(int count) {
+    QMutexLocker lock(&engines_mutex_);
+    max_engines_ = qBound(1, count, 4);
+    tile_pool_.setMaxThreadCount(max_engines_);
+}
+
+void OcrService::setDefaultProfile(const QString& name) {
+    default_profile_ = OcrProfile::byName(name);
+    qDebug() << "[OcrService] default profile" << default_profile_.name;
+}
+
+OcrEngine* OcrService::acquireEngine(const OcrProfile& profile) {
+    QMutexLocker lock(&engines_mutex_);
+    for (;;) {
+        QVector<OcrEngine*>& idle = idle_engines_[profile.name];
+        if (!idle.isEmpty()) {
+            return idle.takeLast();
+        }
+
+        if (int(engines_.size()) < max_engines_) {
+            // 模型在实例第一次识别时懒加载，这里只是占个位；
+            // 切片时 max_engines_ 个实例同时推理，线程数按实例数均分，总数不超过核数
+            engines_.push_back(std::make_unique<OcrEngine>());
+            engines_.back()->setProfile(profile.sizedForPool(max_engines_));
+            return engines_.back().get();
+        }
+
+        // 上限已满：释放一个别的档位的空闲实例腾出名额
+        bool evicted = false;
+        for (auto it = idle_engines_.begin(); it != idle_engines_.end() && !evicted; ++it) {
+            if (it.key() == profile.name || it.value().isEmpty()) {
+                continue;
+            }
+            OcrEngine* victim = it.value().takeLast();
+            for (auto e = engines_.begin(); e != engines_.end(); ++e) {
+                if (e->get() == victim) {
+                    qDebug() << "[OcrService] releasing idle" << it.key() << "engine for" << profile.name;
+                    engines_.erase(e);
+                    break;
+                }
+            }
+            evicted = true;
+        }
+        if (!evicted) {
+            engine_released_.wait(&engines_mutex_);
+        }
+    }
+}
+
+void OcrService::releaseEngine(OcrEngine* engine) {
+    QMutexLocker lock(&engines_mutex_);
+    idle_engines_[engine->profile().name].push_back(engine);
+    engine_released_.wakeAll();
+}
+
+OcrResult OcrService::recognizeOne(const QImage& image, const OcrProfile& profile, QString* error, bool useCache,
+    const OcrEngine::StageCallback& onStage) {
+    OcrEngine* engine = acquireEngine(profile);
+    OcrResult result;
+    try {
+        result = engine->recognize(image, useCache, onStage);
+    }
+    catch (const std::exception& e) {
+        *error = QString::fromLocal8Bit(e.what());
+    }
+    catch (...) {
+        *error = "Unknown Error during OCR dispatch.";
+    }
+    releaseEngine(engine);
+    return result;
+}
+
+OcrResult OcrService::recognizeTiled(quint64 id, const QImage& image, const OcrProfile& profile,
+    const std::shared_ptr<std::atomic_bool>& canceled, QString* error) {
+    // 缓存的是整图合并后的结果；切片本身不进缓存，否则一张长截图的十几片会把别的整图结果挤出去
+    const QByteArray key = OcrResultCache::keyFor(image, profile.name);
+    OcrResult cached;
+    if (OcrResultCache::instance().lookup(key, &cached)) {
+        cached.fromCache = true;
+        return cached;
+    }
+
+    const QVector<OcrTiler::Tile> tiles = OcrTiler::plan(image);
+    const int total = tiles.size();
+    QVector<OcrResult> results(total);
+    QVector<QString> errors(total);
+    std::atomic_int done{ 0 };
+    std::atomic_int skipped{ 0 };
+    QSemaphore finished;
+
+    for (int i = 0; i < total; ++i) {
+        tile_pool_.start([&, i]() {
+            // 取消后剩下的切片直接跳过，已经在跑的那几片跑完为止
+            if (!canceled->load()) {
+                results[i] = recognizeOne(TileView(image, tiles[i].rect), profile, &errors[i], false);
+            }
+            else {
+                ++skipped;
+            }
+            const int n = ++done;
+            postProgress(id, 10 + 85 * n / total, tr("Recognizing %1/%2").arg(n).arg(total));
+            finished.release();
+            });
+    }
+    finished.acquire(total);
+
+    int failed = 0;
+    for (int i = 0; i < total; ++i) {
+        if (!errors[i].isEmpty()) {
+            qWarning() << "[OcrService] tile" << i << tiles[i].rect << "failed:" << errors[i];
+            ++failed;
+        }
+    }
+    // 部分切片失败时仍然返回能识别出来的部分
+    if (failed == total) {
+        *error = errors.first();
+        return OcrResult();
+    }
+    const OcrResult merged = OcrTiler::merge(tiles, results, image.size());
+    // 有切片失败或被取消跳过时结果不完整，不缓存
+    if (failed == 0 && skipped.load() == 0) {
+        OcrResultCache::instance().insert(key, merged);
+    }
+    return merged;
+}
+
+OcrTask* OcrService::recognize(const QImage& image, QObject* owner, const QString& profile) {
+    auto* task = new OcrTask(owner);
+    const quint64 id = next_id_++;
+    tasks_.insert(id, task);
+
+    // 排队状态也走一次事件循环，保证调用方先连好信号
+    postProgress(id, 0, tr("Queued"));
+
+    const OcrProfile chosen = profile.isEmpty() ? default_profile_ : OcrProfile::byName(profile);
+    auto canceled = task->canceled_;
+    QMetaObject::invokeMethod(context_, [this, id, image, chosen, canceled]() {
+        run(id, image, chosen, canceled);
+        }, Qt::QueuedConnection);
+    return task;
+}
+
+void OcrService::run(quint64 id, const QImage& image, const OcrProfile& profile,
+    const std::shared_ptr<std::atomic_bool>& canceled) {
+    if (canceled->load()) {
+        postDone(id, OcrResult(), QString());
+        return;
+    }
+
+    QString error;
+    QElapsedTimer timer;
+    timer.start();
+    const bool tiled = OcrTiler::needsTiling(image.size());
+    OcrResult result;
+    if (tiled) {
+        // 多个切片并行，各自的阶段交错在一起，进度按完成的切片数推进
+        postProgress(id, 10, tr("Recognizing"));
+        result = recognizeTiled(id, image, profile, canceled, &error);
+    }
+    else {
+        result = recognizeOne(image, profile, &error, true,
+            [this, id](OcrEngine::Stage stage) { postStage(id, stage); });
+    }
+    result.totalMs = timer.elapsed();
+
+    const bool warm = ready_profiles_.contains(profile.name);
+    qDebug() << "[OcrService] task" << id << profile.name << image.size() << (tiled ? "tiled" : "single")
+        << result.totalMs << "ms" << (result.fromCache ? "(cache)" : warm ? "(warm)" : "(cold)")
+        << "det" << result.detMs << "cls" << result.clsMs << "rec" << result.recMs
+        << "refine" << result.refineMs << "(" << result.refinedLines << "lines)"
+        << "lines" << result.lines.size();
+    if (error.isEmpty()) {
+        ready_profiles_.insert(profile.name);
+    }
+
+    if (canceled->load()) {
+        qDebug() << "[OcrService] task" << id << "canceled during inference, result dropped";
+    }
+    postDone(id, result, error);
+}
+
+void OcrService::warmUp() {
+    if (warm_up_requested_) {
+        return;
+    }
+    warm_up_requested_ = true;
+
+    // 合成图在 GUI 线程画好：空白图检测不到文本框，识别 / 方向分类模型就跑不到
+    QImage sample(640, 96, QImage::Format_RGB888);
+    sample.fill(Qt::white);
+    {
+        QPainter p(&sample);
+        QFont font = p.font();
+        font.setPixelSize(32);
+        p.setFont(font);
+        p.setPen(Qt::black);
+        p.drawText(sample.rect().adjusted(16, 0, -16, 0), Qt::AlignVCenter | Qt::AlignLeft,
+            QString::fromUtf8("OCR warm-up 预热 0123456789"));
+    }
+
+    const OcrProfile profile = default_profile_;
+    QMetaObject::invokeMethod(context_, [this, sample, profile]() {
+        runWarmUp(sample, profile);
+        }, Qt::QueuedConnection);
+}
+
+void OcrService::runWarmUp(const QImage& sample, const OcrProfile& profile) {
+    // 预热期间把 worker 降到低优先级，不和刚启动的界面抢 CPU；结束后恢复，
+    // 之后排队的真实请求按正常优先级执行
+    QThread::currentThread()->setPriority(QThread::LowPriority);
+
+    WarmUpStats stats;
+    stats.done = true;
+    QString error;
+    QElapsedTimer timer;
+    timer.start();
+    // 预热必须真的跑推理，不能被结果缓存挡掉
+    recognizeOne(sample, profile, &error, false);
+    stats.coldMs = timer.restart();
+    if (error.isEmpty()) {
+        recognizeOne(sample, profile, &error, false);
+        stats.warmMs = timer.elapsed();
+    }
+    stats.ok = error.isEmpty();
+    if (stats.ok) {
+        ready_profiles_.insert(profile.name);
+    }
+    else {
+        qWarning() << "[OcrService] warm-up failed:" << error;
+    }
+
+    QThread::currentThread()->setPriority(QThread::NormalPriority);
+    qDebug() << "[OcrService] warm-up" << profile.name << "cold" << stats.coldMs << "ms, warm" << stats.warmMs << "ms";
+
+    QMetaObject::invokeMethod(this, [this, stats]() {
+        warm_up_stats_ = stats;
+        emit warmUpFinished(stats);
+        }, Qt::QueuedConnection);
+}
+
+void OcrService::postProgress(quint64 id, int percent, const QString& stage) {
+    QMetaObject::invokeMethod(this, [this, id, percent, stage]() {
+        onProgress(id, percent, stage);
+        }, Qt::QueuedConnection);
+}
+
+void OcrService::postStage(quint64 id, OcrEngine::Stage stage) {
+    // 百分比大致按各阶段在 CPU 上的耗时比例分配，识别阶段通常最长
+    switch (stage) {
+    case OcrEngine::Stage::kLoadModels: postProgress(id, 5, tr("Loading models")); break;
+    case OcrEngine::Stage::kDetect: postProgress(id, 15, tr("Detecting text")); break;
+    case OcrEngine::Stage::kClassify: postProgress(id, 40, tr("Classifying orientation")); break;
+    case OcrEngine::Stage::kRecognize: postProgress(id, 50, tr("Recognizing text")); break;
+    case OcrEngine::Stage::kRefine: postProgress(id, 85, tr("Refining low-confidence lines")); break;
+    }
+}
+
+void OcrService::postDone(quint64 id, const OcrResult& result, const QString& error) {
+    QMetaObject::invokeMethod(this, [this, id, result, error]() {
+        onDone(id, result, error);
+        }, Qt::QueuedConnection);
+}
+
+void OcrService::onProgress(quint64 id, int percent, const QString& stage) {
+    const QPointer<OcrTask> task = tasks_.value(id);
+    if (!task || task->isCanceled()) {
+        return;
+    }
+    emit task->progress(percent, stage);
+}
+
+void OcrService::onDone(quint64 id, const OcrResult& result, const QString& error) {
+    const QPointer<OcrTask> task = tasks_.take(id);
+    if (!task || task->isCanceled()) {
+        return;
+    }
+
+    emit task->progress(100, tr("Done"));
+    if (error.isEmpty()) {
+        emit task->resultReady(result);
+    }
+    else {
+        emit task->failed(error);
+    }
+    task->deleteLater();
+}
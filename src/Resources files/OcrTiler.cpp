@@ -0,0 +1,211 @@
+#include "OcrTiler.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+    // 每片沿长边的目标长度：PaddleOCR 检测模型会把长边缩到 960 左右，
+    // 切得太长小字会被缩没，太短则切片数和重复开销变多
+    constexpr int kTileLength = 1600;
+    // 切口可以在目标位置前后这么远的范围内找空白
+    constexpr int kCutSearch = kTileLength / 4;
+    // 至少连续这么多条安静的行 / 列才算行间空白（避免落在笔画内部的细缝上）
+    constexpr int kQuietRun = 4;
+    // 一行内灰度极差不超过这个值视为安静
+    constexpr int kQuietRange = 24;
+    // 找不到空白时相邻切片的重叠量，大约两三行正文
+    constexpr int kFallbackOverlap = 96;
+    // 两个框的交集占较小框面积的比例超过这个值，视为同一行被两片重复识别
+    constexpr double kDuplicateCover = 0.5;
+    // 顶边相差不到这么多像素的框视为同一行，按 x 排序（与 PaddleOCR 的 sorted_boxes 一致）
+    constexpr int kSameRowTolerance = 10;
+
+    qint64 Area(const QRect& r)
+    {
+        return r.isEmpty() ? 0 : qint64(r.width()) * r.height();
+    }
+
+    double Cover(const QRect& a, const QRect& b)
+    {
+        const qint64 smaller = std::min(Area(a), Area(b));
+        return smaller > 0 ? double(Area(a & b)) / double(smaller) : 0.0;
+    }
+
+    void SortReadingOrder(QVector<OcrLine>& lines)
+    {
+        std::stable_sort(lines.begin(), lines.end(), [](const OcrLine& a, const OcrLine& b) {
+            return a.boundingRect().top() < b.boundingRect().top();
+            });
+        for (int i = 1; i < lines.size(); ++i) {
+            for (int j = i; j > 0; --j) {
+                const QRect prev = lines[j - 1].boundingRect();
+                const QRect cur = lines[j].boundingRect();
+                if (std::abs(cur.top() - prev.top()) >= kSameRowTolerance || cur.left() >= prev.left()) {
+                    break;
+                }
+                std::swap(lines[j - 1], lines[j]);
+            }
+        }
+    }
+
+} // namespace
+
+bool OcrTiler::needsTiling(const QSize& size)
+{
+    return qMax(size.width(), size.height()) > kTileLength * 3 / 2;
+}
+
+bool OcrTiler::isQuietLine(const QImage& image, bool alongHeight, int index)
+{
+    // alongHeight = true 表示沿高度切（横条），检查第 index 行；否则检查第 index 列
+    const int length = alongHeight ? image.width() : image.height();
+    int lo = 255;
+    int hi = 0;
+    // 隔一个像素采样，空白行判断对精度不敏感
+    for (int i = 0; i < length; i += 2) {
+        const QRgb px = alongHeight ? image.pixel(i, index) : image.pixel(index, i);
+        const int g = qGray(px);
+        lo = std::min(lo, g);
+        hi = std::max(hi, g);
+        if (hi - lo > kQuietRange) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int OcrTiler::findQuietCut(const QImage& image, bool alongHeight, int nominal, int from, int to)
+{
+    // 先标出窗口内所有安静的行，再找离 nominal 最近的、足够宽的空白带中点
+    const int count = to - from + 1;
+    if (count <= 0) {
+        return -1;
+    }
+    QVector<bool> quiet(count);
+    for (int i = 0; i < count; ++i) {
+        quiet[i] = isQuietLine(image, alongHeight, from + i);
+    }
+
+    int best = -1;
+    int bestDistance = INT_MAX;
+    int runStart = -1;
+    for (int i = 0; i <= count; ++i) {
+        if (i < count && quiet[i]) {
+            if (runStart < 0) runStart = i;
+            continue;
+        }
+        if (runStart >= 0 && i - runStart >= kQuietRun) {
+            const int cut = from + (runStart + i) / 2;
+            const int distance = std::abs(cut - nominal);
+            if (distance < bestDistance) {
+                best = cut;
+                bestDistance = distance;
+            }
+        }
+        runStart = -1;
+    }
+    return best;
+}
+
+QVector<OcrTiler::Tile> OcrTiler::plan(const QImage& source)
+{
+    QVector<Tile> tiles;
+    if (source.isNull()) {
+        return tiles;
+    }
+    if (!needsTiling(source.size())) {
+        tiles.push_back(Tile{ source.rect(), 0 });
+        return tiles;
+    }
+
+    // pixel() 对 32 位格式最快；原图通常已经是 RGB32 / ARGB32，转换不会复制
+    const QImage image = (source.format() == QImage::Format_RGB32 ||
+        source.format() == QImage::Format_ARGB32 ||
+        source.format() == QImage::Format_ARGB32_Premultiplied)
+        ? source : source.convertToFormat(QImage::Format_RGB32);
+
+    const bool alongHeight = image.height() >= image.width();
+    const int total = alongHeight ? image.height() : image.width();
+    // 均分成若干片，让每片长度接近 kTileLength 且末片不会过短
+    const int pieces = (total + kTileLength - 1) / kTileLength;
+    const int step = (total + pieces - 1) / pieces;
+
+    int start = 0;
+    int overlap = 0;
+    while (start < total) {
+        const int nominal = start + step;
+        int end = total;
+        int nextStart = total;
+        int nextOverlap = 0;
+        if (nominal < total - step / 2) {
+            const int from = std::max(start + step / 2, nominal - kCutSearch);
+            const int to = std::min(total - 1, nominal + kCutSearch);
+            const int cut = findQuietCut(image, alongHeight, nominal, from, to);
+            if (cut >= 0) {
+                end = cut;
+                nextStart = cut;
+            }
+            else {
+                end = std::min(total, nominal + kFallbackOverlap / 2);
+                nextStart = std::max(start + 1, nominal - kFallbackOverlap / 2);
+                nextOverlap = end - nextStart;
+            }
+        }
+
+        const QRect rect = alongHeight
+            ? QRect(0, start, image.width(), end - start)
+            : QRect(start, 0, end - start, image.height());
+        tiles.push_back(Tile{ rect, overlap });
+
+        start = nextStart;
+        overlap = nextOverlap;
+    }
+    return tiles;
+}
+
+OcrResult OcrTiler::merge(const QVector<Tile>& tiles, const QVector<OcrResult>& results, const QSize& imageSize)
+{
+    OcrResult merged;
+    merged.imageSize = imageSize;
+
+    int prevBegin = 0;
+    for (int t = 0; t < tiles.size() && t < results.size(); ++t) {
+        const OcrResult& r = results[t];
+        merged.detMs += r.detMs;
+        merged.clsMs += r.clsMs;
+        merged.recMs += r.recMs;
+        merged.refineMs += r.refineMs;
+        merged.refinedLines += r.refinedLines;
+
+        const int prevEnd = merged.lines.size();
+        const QPoint offset = tiles[t].rect.topLeft();
+        for (OcrLine line : r.lines) {
+            line.polygon.translate(offset);
+
+            // 只有切在重叠处时才会重复：和前一片的框比较，保留面积更大（没被切口截断）的那个
+            bool duplicate = false;
+            if (tiles[t].overlapBefore > 0) {
+                const QRect box = line.boundingRect();
+                for (int j = prevBegin; j < prevEnd; ++j) {
+                    const QRect other = merged.lines[j].boundingRect();
+                    if (Cover(box, other) >= kDuplicateCover) {
+                        if (Area(box) > Area(other)) {
+                            merged.lines[j] = line;
+                        }
+                        duplicate = true;
+                        break;
+                    }
+                }
+            }
+            if (!duplicate) {
+                merged.lines.push_back(line);
+            }
+        }
+        prevBegin = prevEnd;
+    }
+
+    SortReadingOrder(merged.lines);
+    return merged;
+}
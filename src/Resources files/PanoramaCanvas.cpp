@@ -0,0 +1,171 @@
+#include "PanoramaCanvas.h"
+
+#include <QPainter>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    // 换比例时只用放得下的比例的 3/4，画布继续长大一段后才需要再次整张重画
+    constexpr double kThumbHeadroom = 0.75;
+
+    // 画布坐标矩形缩放后覆盖到的整数像素
+    QRect ScaledRect(const QRect& r, double scale)
+    {
+        const int left = int(std::floor(r.left() * scale));
+        const int top = int(std::floor(r.top() * scale));
+        const int right = int(std::ceil((r.right() + 1) * scale));
+        const int bottom = int(std::ceil((r.bottom() + 1) * scale));
+        return QRect(QPoint(left, top), QPoint(right - 1, bottom - 1));
+    }
+
+} // namespace
+
+void PanoramaCanvas::clear()
+{
+    tiles_.clear();
+    bounds_ = QRect();
+    thumb_ = QImage();
+    thumbRect_ = QRect();
+    thumbScale_ = 0.0;
+    thumbDirty_ = QRect();
+}
+
+int PanoramaCanvas::tileIndex(int v)
+{
+    // 向下取整，负坐标也落在正确的 tile 里
+    return v >= 0 ? v / kTileSize : -((-v + kTileSize - 1) / kTileSize);
+}
+
+quint64 PanoramaCanvas::tileKey(int tx, int ty)
+{
+    return (quint64(quint32(tx)) << 32) | quint32(ty);
+}
+
+void PanoramaCanvas::paste(const QImage& image, const QPoint& pos)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    const QImage src = image.format() == QImage::Format_ARGB32_Premultiplied
+        ? image : image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const QRect area(pos, src.size());
+    bounds_ = bounds_.isNull() ? area : bounds_.united(area);
+    thumbDirty_ = thumbDirty_.isNull() ? area : thumbDirty_.united(area);
+
+    for (int ty = tileIndex(area.top()); ty <= tileIndex(area.bottom()); ++ty) {
+        for (int tx = tileIndex(area.left()); tx <= tileIndex(area.right()); ++tx) {
+            QImage& tile = tiles_[tileKey(tx, ty)];
+            if (tile.isNull()) {
+                tile = QImage(kTileSize, kTileSize, QImage::Format_ARGB32_Premultiplied);
+                tile.fill(Qt::transparent);
+            }
+
+            const QRect tr(tx * kTileSize, ty * kTileSize, kTileSize, kTileSize);
+            const QRect part = tr.intersected(area);
+            const size_t bytes = size_t(part.width()) * 4;
+            for (int y = part.top(); y <= part.bottom(); ++y) {
+                memcpy(tile.scanLine(y - tr.top()) + (part.left() - tr.left()) * 4,
+                    src.constScanLine(y - area.top()) + (part.left() - area.left()) * 4, bytes);
+            }
+        }
+    }
+}
+
+QImage PanoramaCanvas::copy(const QRect& area, QColor background) const
+{
+    if (area.isEmpty()) {
+        return QImage();
+    }
+
+    QImage out(area.size(), QImage::Format_ARGB32_Premultiplied);
+    out.fill(background);
+
+    QPainter p(&out);
+    for (int ty = tileIndex(area.top()); ty <= tileIndex(area.bottom()); ++ty) {
+        for (int tx = tileIndex(area.left()); tx <= tileIndex(area.right()); ++tx) {
+            auto it = tiles_.constFind(tileKey(tx, ty));
+            if (it == tiles_.constEnd()) continue;
+            // 透明部分（没覆盖到）保留背景色
+            p.drawImage(QPoint(tx * kTileSize, ty * kTileSize) - area.topLeft(), it.value());
+        }
+    }
+    p.end();
+    return out;
+}
+
+QImage PanoramaCanvas::thumbnail(const QSize& maxSize)
+{
+    if (bounds_.isEmpty() || maxSize.isEmpty()) {
+        return QImage();
+    }
+
+    const QSize needed = ScaledRect(bounds_, thumbScale_).size();
+    if (thumb_.isNull() || maxSize != thumbMaxSize_
+        || needed.width() > maxSize.width() || needed.height() > maxSize.height()) {
+        // 当前比例放不下（或第一次生成）：换比例，整张重画
+        const double fit = qMin(double(maxSize.width()) / bounds_.width(),
+            double(maxSize.height()) / bounds_.height());
+        thumbScale_ = fit >= 1.0 ? 1.0 : fit * kThumbHeadroom;
+        thumbMaxSize_ = maxSize;
+        thumbRect_ = ScaledRect(bounds_, thumbScale_);
+        thumb_ = QImage(thumbRect_.size(), QImage::Format_ARGB32_Premultiplied);
+        thumb_.fill(Qt::transparent);
+        renderThumbnail(bounds_);
+    }
+    else {
+        const QRect grown = thumbRect_.united(ScaledRect(bounds_, thumbScale_));
+        if (grown != thumbRect_) {
+            // 比例不变只是画布变大：旧缩略图按整数偏移搬过去，不需要重新缩放
+            QImage larger(grown.size(), QImage::Format_ARGB32_Premultiplied);
+            larger.fill(Qt::transparent);
+            QPainter p(&larger);
+            p.setCompositionMode(QPainter::CompositionMode_Source);
+            p.drawImage(thumbRect_.topLeft() - grown.topLeft(), thumb_);
+            p.end();
+            thumb_ = larger;
+            thumbRect_ = grown;
+        }
+        if (!thumbDirty_.isNull()) {
+            renderThumbnail(thumbDirty_);
+        }
+    }
+    thumbDirty_ = QRect();
+    return thumb_;
+}
+
+void PanoramaCanvas::renderThumbnail(const QRect& area)
+{
+    // 只清掉并重画 area 覆盖到的缩略图像素；tile 的目标位置和整张重画时完全相同，
+    // 靠裁剪限制范围，所以增量结果和整张重画一致
+    const QRect scaled = ScaledRect(area, thumbScale_).intersected(thumbRect_);
+    if (scaled.isEmpty()) {
+        return;
+    }
+    const QRect target = scaled.translated(-thumbRect_.topLeft());
+
+    QPainter p(&thumb_);
+    p.setClipRect(target);
+    p.setCompositionMode(QPainter::CompositionMode_Clear);
+    p.fillRect(target, Qt::transparent);
+    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    p.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // 对齐到整像素后的目标范围比 area 稍大，按它反算回画布坐标（再多留一像素给缩放滤波）找 tile
+    const QRect source(QPoint(int(std::floor(scaled.left() / thumbScale_)) - 1,
+        int(std::floor(scaled.top() / thumbScale_)) - 1),
+        QPoint(int(std::ceil((scaled.right() + 1) / thumbScale_)) + 1,
+            int(std::ceil((scaled.bottom() + 1) / thumbScale_)) + 1));
+    for (int ty = tileIndex(source.top()); ty <= tileIndex(source.bottom()); ++ty) {
+        for (int tx = tileIndex(source.left()); tx <= tileIndex(source.right()); ++tx) {
+            auto it = tiles_.constFind(tileKey(tx, ty));
+            if (it == tiles_.constEnd()) continue;
+            const QRectF dst(tx * kTileSize * thumbScale_ - thumbRect_.left(),
+                ty * kTileSize * thumbScale_ - thumbRect_.top(),
+                kTileSize * thumbScale_, kTileSize * thumbScale_);
+            p.drawImage(dst, it.value());
+        }
+    }
+    p.end();
+}
@@ -1,5 +1,5 @@
 #include "PinnedWindow.h"
-#include "OCR.h"
+#include "OcrService.h"
 #include "OcrResultDialog.h"
 
 #include <QMouseEvent>
@@ -338,31 +338,16 @@ void PinnedWindow::OnTogglePin() {
 }
 
 void PinnedWindow::OnOcr() {
-    auto* engine = &OcrEngine::instance();
-
     auto* dlg = new OcrResultDialog(pixmap_, "Recognizing...", nullptr);
     dlg->show();
     dlg->raise();
 
-    QPointer<OcrResultDialog> safeDlg(dlg);
-
-    QTimer::singleShot(100, [engine, safeDlg, this]() {
-        if (!safeDlg) return;
-
-        QString result;
-        try {
-            result = engine->detectText(pixmap_.toImage());
-        }
-        catch (const std::exception& e) {
-            result = QString("Error: %1").arg(e.what());
-        }
-        catch (...) {
-            result = "Unknown Error during OCR dispatch.";
-        }
-
-        if (safeDlg) {
-            safeDlg->SetResultText(result);
-        }
+    // 在 worker 线程识别，关闭对话框即取消
+    OcrTask* task = OcrService::instance().recognize(pixmap_.toImage(), dlg);
+    connect(task, &OcrTask::progress, dlg, &OcrResultDialog::SetProgress);
+    connect(task, &OcrTask::resultReady, dlg, &OcrResultDialog::SetResult);
+    connect(task, &OcrTask::failed, dlg, [dlg](const QString& error) {
+        dlg->SetResultText(QString("Error: %1").arg(error));
         });
 }
 
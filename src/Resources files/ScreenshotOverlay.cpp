@@ -1,4 +1,5 @@
 #include "ScreenshotOverlay.h"
+#include "OcrService.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <QKeyEvent>
@@ -15,6 +16,7 @@
 #include <QTimer>
 #include <QPointer>
 #include <QShowEvent>
+#include <QPaintEvent>
 
 #include <QPainterPath>      // 新增：QPainterPath
 #include <algorithm>         // 新增：std::min/std::max
@@ -107,7 +109,7 @@ void ScreenshotOverlay::SetBackground(const QPixmap& pixmap)
     update();
 }
 
-void ScreenshotOverlay::paintEvent(QPaintEvent* /*event*/)
+void ScreenshotOverlay::paintEvent(QPaintEvent* event)
 {
     QPainter painter(this);
 
@@ -147,7 +149,10 @@ void ScreenshotOverlay::paintEvent(QPaintEvent* /*event*/)
         QRect target = sel;
         if (stage_ == Stage::kEditing && !canvas_.isNull()) {
             QRect src = ComputeZoomSourceRect(canvas_.size());
-            painter.drawPixmap(target, canvas_, src);
+            // 只画与本次重绘区域相交的 tile
+            canvas_.draw(painter, target, src, event->rect());
+            // 拖动中的预览项单独叠加，不写回 canvas_
+            PaintPreviewItem(painter, target, src);
         }
         else if (!background_.isNull()) {
             QPixmap sub = background_.copy(sel);
@@ -206,15 +211,7 @@ void ScreenshotOverlay::mousePressEvent(QMouseEvent* event)
         QPoint local = pos - selection_.topLeft();
 
         if (draw_mode_ != DrawMode::kNone) {
-            // 在绘制前保存快照，供 Undo 使用（保存 image + items）
-            if (!canvas_.isNull()) {
-                UndoState st;
-                st.image = canvas_.toImage();
-                st.items = items_;
-                undo_stack_.push_back(std::move(st));
-                redo_stack_.clear();
-            }
-
+            // 撤销记录在松开鼠标、items_ 真正变化时再生成
             is_drawing_ = true;
             edit_start_pos_ = local;
             edit_current_pos_ = local;
@@ -267,13 +264,14 @@ void ScreenshotOverlay::mousePressEvent(QMouseEvent* event)
                 preview_item_->type = DrawItem::Type::kBlur;
                 preview_item_->rect = QRect(edit_start_pos_, edit_start_pos_);
                 preview_item_->blur_opacity = blurTool_ ? blurTool_->opacity() : 50;
+                preview_item_->blur_radius = blurTool_ ? blurTool_->radius() : 15;
                 break;
             default:
                 break;
             }
 
-            // 即时绘制预览
-            RepaintCanvasFromItems(preview_item_.get());
+            // 即时绘制预览（preview 在 paintEvent 中叠加）
+            update();
         }
     }
 }
@@ -365,7 +363,8 @@ void ScreenshotOverlay::mouseMoveEvent(QMouseEvent* event)
             }
         }
 
-        RepaintCanvasFromItems(preview_item_.get());
+        // 已提交图层不变，只需重绘 preview
+        update();
         return;
     }
 
@@ -456,8 +455,7 @@ void ScreenshotOverlay::mouseReleaseEvent(QMouseEvent* event)
         // 完成预览并把 preview_item_ 转为正式 item（或执行对象擦除）
         if (preview_item_->type == DrawItem::Type::kEraserFree) {
             // 自由像素擦除：把一个 EraserFree item push 到 items_
-            DrawItem itm = *preview_item_;
-            items_.push_back(itm);
+            CommitItem(*preview_item_);
         }
         else {
             // 对象橡皮模式（Shift）: 删除被擦除对象
@@ -465,15 +463,16 @@ void ScreenshotOverlay::mouseReleaseEvent(QMouseEvent* event)
                 // preview_item_->path 存储了擦除轨迹
                 QVector<QPoint> erasePath = preview_item_->path;
                 int radius = preview_item_->stroke_width;
-                QVector<int> removeIdx;
-                for (int i = 0; i < items_.size(); ++i) {
-                    if (ItemHitTest(items_[i], erasePath, radius)) {
-                        removeIdx.append(i);
+                QVector<int> removeIdx = HitTestItems(erasePath, radius);
+                if (!removeIdx.isEmpty()) {
+                    EditCommand cmd;
+                    cmd.kind = EditCommand::Kind::kRemove;
+                    cmd.indices = removeIdx;
+                    for (int idx : removeIdx) {
+                        cmd.before.append(items_[idx]);
                     }
-                }
-                // 从后往前删除
-                for (int i = removeIdx.size() - 1; i >= 0; --i) {
-                    items_.remove(removeIdx[i]);
+                    ApplyCommand(cmd, true);
+                    PushCommand(std::move(cmd));
                 }
             }
             else {
@@ -481,16 +480,16 @@ void ScreenshotOverlay::mouseReleaseEvent(QMouseEvent* event)
                 DrawItem itm = *preview_item_;
                 // normalize rect if needed
                 if (!itm.rect.isNull()) itm.rect = itm.rect.normalized();
-                items_.push_back(itm);
+                CommitItem(itm);
             }
         }
 
-        // 清除 preview 并重绘 canvas
+        // 清除 preview；只有 items_ 被非追加式修改时才会真正重建 tile
+        UpdateCanvasArea(ItemBounds(*preview_item_));
         preview_item_.reset();
-        RepaintCanvasFromItems(nullptr);
+        RepaintCanvasFromItems();
 
         modified_ = true;
-        update();
     }
 }
 
@@ -662,12 +661,14 @@ void ScreenshotOverlay::StartEditingIfNeeded()
 
     // 先把选区剪成 base_pixmap_，后续所有绘制都叠加在这个基础图上
     base_pixmap_ = background_.copy(selection_);
-    canvas_ = base_pixmap_;
+    canvas_.reset(base_pixmap_);
 
     modified_ = false;
     undo_stack_.clear();
     redo_stack_.clear();
+    undo_bytes_ = 0;
     items_.clear();
+    hit_index_.clear();
     preview_item_.reset();
 
     stage_ = Stage::kEditing;
@@ -679,7 +680,7 @@ QPixmap ScreenshotOverlay::CurrentResultPixmap() const
     QRect sel = selection_.normalized();
 
     if (stage_ == Stage::kEditing && !canvas_.isNull()) {
-        return canvas_;
+        return canvas_.toPixmap();
     }
     if (!sel.isNull() && !background_.isNull()) {
         return background_.copy(sel);
@@ -745,33 +746,17 @@ void ScreenshotOverlay::RunLocalOcr() {
     dlg->move(this->geometry().center() - dlg->rect().center());
     dlg->show();
 
+    // 推理在 OcrService 的 worker 线程里进行；任务句柄挂在对话框上，
+    // 对话框关闭时句柄随之销毁，请求自动取消
+    OcrTask* task = OcrService::instance().recognize(result.toImage(), dlg);
+    connect(task, &OcrTask::progress, dlg, &OcrResultDialog::SetProgress);
+    connect(task, &OcrTask::resultReady, dlg, &OcrResultDialog::SetResult);
+    connect(task, &OcrTask::failed, dlg, [dlg](const QString& error) {
+        dlg->SetResultText(QString("Error: %1").arg(error));
+        });
+
     // 关闭截图区域
     close();
-
-    // 异步执行 OCR，避免阻塞 UI 关闭
-    // 使用 QPointer 确保安全
-    QPointer<OcrResultDialog> safeDlg(dlg);
-
-    QTimer::singleShot(100, [result, safeDlg]() {
-        if (!safeDlg) return;
-
-        auto* engine = &OcrEngine::instance();
-        QString text;
-        try {
-            // 同步调用
-            text = engine->detectText(result.toImage());
-        }
-        catch (const std::exception& e) {
-            text = QString("Error: %1").arg(e.what());
-        }
-        catch (...) {
-            text = "Unknown Error during OCR dispatch.";
-        }
-
-        if (safeDlg) {
-            safeDlg->SetResultText(text);
-        }
-        });
 }
 
 //AI 描述
@@ -812,19 +797,12 @@ void ScreenshotOverlay::Undo()
     if (undo_stack_.isEmpty() || canvas_.isNull()) {
         return;
     }
-    // 当前状态推到 redo
-    {
-        UndoState cur;
-        cur.image = canvas_.toImage();
-        cur.items = items_;
-        redo_stack_.push_back(std::move(cur));
-    }
-    // 弹出一个 undo 状态恢复
-    UndoState st = undo_stack_.takeLast();
-    canvas_ = QPixmap::fromImage(st.image);
-    items_ = st.items;
+    // 弹出最近一条命令并反向执行，再推到 redo
+    EditCommand cmd = undo_stack_.takeLast();
+    undo_bytes_ -= CommandBytes(cmd);
+    ApplyCommand(cmd, false);
+    redo_stack_.push_back(std::move(cmd));
     modified_ = true;
-    update();
 }
 
 
@@ -833,19 +811,79 @@ void ScreenshotOverlay::Redo()
     if (redo_stack_.isEmpty() || canvas_.isNull()) {
         return;
     }
-    // 当前状态推到 undo
-    {
-        UndoState cur;
-        cur.image = canvas_.toImage();
-        cur.items = items_;
-        undo_stack_.push_back(std::move(cur));
-    }
-    // 弹出一个 redo 状态恢复
-    UndoState st = redo_stack_.takeLast();
-    canvas_ = QPixmap::fromImage(st.image);
-    items_ = st.items;
+    // 弹出一条 redo 命令正向执行，再推回 undo（不清空 redo 栈）
+    EditCommand cmd = redo_stack_.takeLast();
+    ApplyCommand(cmd, true);
+    undo_bytes_ += CommandBytes(cmd);
+    undo_stack_.push_back(std::move(cmd));
+    TrimUndoStack();
     modified_ = true;
-    update();
+}
+
+void ScreenshotOverlay::SetUndoMemoryBudget(qint64 bytes)
+{
+    undo_memory_budget_ = qMax<qint64>(0, bytes);
+    TrimUndoStack();
+}
+
+void ScreenshotOverlay::PushCommand(EditCommand cmd)
+{
+    redo_stack_.clear();
+    undo_bytes_ += CommandBytes(cmd);
+    undo_stack_.push_back(std::move(cmd));
+    TrimUndoStack();
+}
+
+void ScreenshotOverlay::TrimUndoStack()
+{
+    // 撤销深度随之变浅；最近一条始终保留，否则刚做的操作就撤销不了
+    while (undo_stack_.size() > 1 && undo_bytes_ > undo_memory_budget_) {
+        undo_bytes_ -= CommandBytes(undo_stack_.takeFirst());
+    }
+}
+
+void ScreenshotOverlay::ApplyCommand(const EditCommand& cmd, bool forward)
+{
+    const bool inserting =
+        (cmd.kind == EditCommand::Kind::kAdd && forward) ||
+        (cmd.kind == EditCommand::Kind::kRemove && !forward);
+    const QVector<DrawItem>& inserted = (cmd.kind == EditCommand::Kind::kAdd) ? cmd.after : cmd.before;
+
+    if (inserting) {
+        // 下标升序插入，保证每个对象回到原来的位置
+        for (int k = 0; k < cmd.indices.size(); ++k) {
+            const int idx = cmd.indices[k];
+            items_.insert(idx, inserted[k]);
+            IndexItem(inserted[k]);
+            if (idx == items_.size() - 1 && !canvas_.hasDirty()) {
+                AppendItemToCanvas(inserted[k]);   // 位于最上层，直接叠加
+            }
+            else {
+                InvalidateCanvas(ItemBounds(inserted[k]));
+            }
+        }
+    }
+    else {
+        // 下标降序删除，避免前面的删除影响后面的下标
+        for (int k = cmd.indices.size() - 1; k >= 0; --k) {
+            InvalidateCanvas(ItemBounds(items_[cmd.indices[k]]));
+            hit_index_.remove(items_[cmd.indices[k]].id);
+            items_.remove(cmd.indices[k]);
+        }
+    }
+
+    RepaintCanvasFromItems();
+}
+
+qint64 ScreenshotOverlay::CommandBytes(const EditCommand& cmd)
+{
+    qint64 bytes = sizeof(EditCommand) + cmd.indices.size() * sizeof(int);
+    for (const QVector<DrawItem>* list : { &cmd.before, &cmd.after }) {
+        for (const DrawItem& it : *list) {
+            bytes += sizeof(DrawItem) + it.path.size() * sizeof(QPoint);
+        }
+    }
+    return bytes;
 }
 
 
@@ -1224,108 +1262,258 @@ void ScreenshotOverlay::showToolPopup(QWidget* popup)
 //    return false;
 //}
 // ---------- 合成渲染：从 base_pixmap_ + items_ 重新生成 canvas_ ----------
-void ScreenshotOverlay::RepaintCanvasFromItems(const DrawItem* preview /*= nullptr*/) {
-    if (base_pixmap_.isNull()) return;
-    canvas_ = base_pixmap_.copy();
-
-    auto drawItem = [&](const DrawItem& it) {
-        switch (it.type) {
-        case DrawItem::Type::kRect: {
-            ShapeDrawer::DrawRect(canvas_, it.rect, it.color, it.stroke_width);
-            break;
-        }
-        case DrawItem::Type::kEllipse: {
-            ShapeDrawer::DrawEllipse(canvas_, it.rect, it.color, it.stroke_width);
-            break;
-        }
-        case DrawItem::Type::kArrow: {
-            ShapeDrawer::DrawArrow(canvas_, it.p1.toPoint(), it.p2.toPoint(), it.color, it.stroke_width);
-            break;
-        }
-        case DrawItem::Type::kPen: {
-            ShapeDrawer::DrawPen(canvas_, it.path, it.color, it.stroke_width);
-            break;
-        }
-        case DrawItem::Type::kMosaic: {
-            // 使用现有马赛克工具，注意传入的是 canvas_ 的坐标系（area 相对于 canvas）
-            if (mosaicTool_) {
-                MosaicTool::applyEffect(canvas_, it.rect, it.mosaic_level);
-            }
-            break;
-        }
-        case DrawItem::Type::kBlur: {
-            if (blurTool_) {
-                BlurTool::applyEffect(canvas_, it.rect, it.blur_opacity);
+// canvas_ 只保存已提交 items_ 的合成结果，拖动中的 preview_item_ 在 paintEvent 里叠加，
+// 因此拖动时的开销与已有标注数量无关。canvas_ 按 tile 记录脏区，
+// 提交 / 擦除只会重建对象外接矩形覆盖到的 tile，并只刷新对应的屏幕区域。
+void ScreenshotOverlay::RepaintCanvasFromItems() {
+    if (base_pixmap_.isNull() || canvas_.isNull()) return;
+
+    if (canvas_.hasDirty()) {
+        QRect touched;
+        canvas_.recompose([this, &touched](QPixmap& patch, const QRect& area) {
+            RenderCanvasArea(patch, area);
+            touched |= area;
+            });
+        UpdateCanvasArea(touched);
+    }
+}
+
+void ScreenshotOverlay::AppendItemToCanvas(const DrawItem& item) {
+    if (canvas_.isNull()) return;
+
+    // 新 item 总是在最上层，直接叠加到它覆盖的 tile 上即可得到与整体重放相同的结果
+    const QRect area = ItemBounds(item).intersected(canvas_.rect());
+    canvas_.modify(area, [this, &item](QPixmap& patch, const QRect& r) {
+        DrawItemOnto(patch, item, r.topLeft());
+        });
+    UpdateCanvasArea(area);
+}
+
+void ScreenshotOverlay::InvalidateCanvas(const QRect& area) {
+    canvas_.markDirty(area);
+}
+
+void ScreenshotOverlay::RenderCanvasArea(QPixmap& patch, const QRect& area) const {
+    // 马赛克 / 模糊会读取自身 rect 内的全部像素，所以渲染范围要扩展到
+    // 与之相交的像素类对象的完整 rect（反复扩展直到不再变化），最后只取回 area 部分
+    QRect region = area;
+    bool grown = true;
+    while (grown) {
+        grown = false;
+        for (const DrawItem& it : items_) {
+            if (it.type != DrawItem::Type::kMosaic && it.type != DrawItem::Type::kBlur) continue;
+            const QRect b = ItemBounds(it).intersected(canvas_.rect());
+            if (b.intersects(region) && !region.contains(b)) {
+                region |= b;
+                grown = true;
             }
-            break;
-        }
-        case DrawItem::Type::kEraserFree: {
-            ShapeDrawer::ErasePen(canvas_, it.path, it.stroke_width);
-            break;
         }
-        default:
-            break;
-        }
-        };
+    }
 
-    // 绘制已提交 items_
+    QPixmap work = base_pixmap_.copy(region);
+    work.setDevicePixelRatio(1.0);
     for (const DrawItem& it : items_) {
-        drawItem(it);
+        if (ItemBounds(it).intersects(region)) {
+            DrawItemOnto(work, it, region.topLeft());
+        }
     }
 
-    // 绘制 preview（不加入 items）
-    if (preview) {
-        drawItem(*preview);
+    QPainter p(&patch);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    p.drawPixmap(QRect(QPoint(0, 0), area.size()), work, area.translated(-region.topLeft()));
+}
+
+void ScreenshotOverlay::UpdateCanvasArea(const QRect& area) {
+    const QRect sel = selection_.normalized();
+    const QRect src = ComputeZoomSourceRect(canvas_.size());
+    if (area.isEmpty() || sel.isEmpty() || src.isEmpty()) {
+        update();
+        return;
     }
+    const double sx = double(sel.width()) / src.width();
+    const double sy = double(sel.height()) / src.height();
+    const QRectF mapped(sel.x() + (area.x() - src.x()) * sx,
+        sel.y() + (area.y() - src.y()) * sy,
+        area.width() * sx,
+        area.height() * sy);
+    update(mapped.toAlignedRect().adjusted(-1, -1, 1, 1).intersected(sel));
+}
 
-    update();
+void ScreenshotOverlay::DrawItemOnto(QPixmap& target, const DrawItem& it, const QPoint& origin) const {
+    const QRect rect = it.rect.translated(-origin);
+    auto localPath = [&]() {
+        if (origin.isNull()) return it.path;
+        QVector<QPoint> path = it.path;
+        for (QPoint& p : path) p -= origin;
+        return path;
+        };
+
+    switch (it.type) {
+    case DrawItem::Type::kRect: {
+        ShapeDrawer::DrawRect(target, rect, it.color, it.stroke_width);
+        break;
+    }
+    case DrawItem::Type::kEllipse: {
+        ShapeDrawer::DrawEllipse(target, rect, it.color, it.stroke_width);
+        break;
+    }
+    case DrawItem::Type::kArrow: {
+        ShapeDrawer::DrawArrow(target, it.p1.toPoint() - origin, it.p2.toPoint() - origin, it.color, it.stroke_width);
+        break;
+    }
+    case DrawItem::Type::kPen: {
+        ShapeDrawer::DrawPen(target, localPath(), it.color, it.stroke_width);
+        break;
+    }
+    case DrawItem::Type::kMosaic: {
+        // 使用现有马赛克工具，注意传入的是 target 的坐标系（area 相对于 target）
+        if (mosaicTool_) {
+            MosaicTool::applyEffect(target, rect, it.mosaic_level);
+        }
+        break;
+    }
+    case DrawItem::Type::kBlur: {
+        if (blurTool_) {
+            BlurTool::applyEffect(target, rect, it.blur_radius, it.blur_opacity);
+        }
+        break;
+    }
+    case DrawItem::Type::kEraserFree: {
+        ShapeDrawer::ErasePen(target, localPath(), it.stroke_width);
+        break;
+    }
+    default:
+        break;
+    }
 }
 
-// 简单的 hit-test：基于 bounding box 扩展橡皮半径，或检测路径点距离
-bool ScreenshotOverlay::ItemHitTest(const DrawItem& item, const QVector<QPoint>& eraserPath, int eraserRadius) const {
-    if (eraserPath.isEmpty()) return false;
-    QRect itemRect = item.rect;
-    if (item.type == DrawItem::Type::kPen) {
-        // compute bounding rect from path
-        if (!item.path.isEmpty()) {
-            int minx = item.path[0].x(), miny = item.path[0].y();
-            int maxx = minx, maxy = miny;
-            for (const QPoint& p : item.path) {
-                minx = std::min(minx, p.x()); miny = std::min(miny, p.y());
-                maxx = std::max(maxx, p.x()); maxy = std::max(maxy, p.y());
-            }
-            itemRect = QRect(QPoint(minx, miny), QPoint(maxx, maxy));
+void ScreenshotOverlay::PaintPreviewItem(QPainter& painter, const QRect& target, const QRect& src) const {
+    if (!preview_item_ || src.isEmpty() || target.isEmpty()) return;
+    const DrawItem& it = *preview_item_;
+
+    painter.save();
+    painter.setClipRect(target);
+    // 画布坐标 -> widget 坐标，与 drawPixmap(target, canvas_, src) 的映射保持一致
+    painter.translate(target.topLeft());
+    painter.scale(double(target.width()) / src.width(), double(target.height()) / src.height());
+    painter.translate(-src.topLeft());
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    switch (it.type) {
+    case DrawItem::Type::kRect:
+        ShapeDrawer::DrawRectPreview(painter, it.rect, it.color, it.stroke_width);
+        break;
+    case DrawItem::Type::kEllipse:
+        ShapeDrawer::DrawEllipsePreview(painter, it.rect, it.color, it.stroke_width);
+        break;
+    case DrawItem::Type::kArrow:
+        ShapeDrawer::DrawArrowPreview(painter, it.p1.toPoint(), it.p2.toPoint(), it.color, it.stroke_width);
+        break;
+    case DrawItem::Type::kPen:
+        ShapeDrawer::DrawPenPreview(painter, it.path, it.color, it.stroke_width);
+        break;
+    case DrawItem::Type::kMosaic:
+    case DrawItem::Type::kBlur:
+    case DrawItem::Type::kEraserFree: {
+        // 像素类效果只作用于自身范围：从已提交图层裁出这一小块处理后贴回
+        const QRect area = ItemBounds(it).intersected(canvas_.rect());
+        if (area.isEmpty()) break;
+        QPixmap patch = canvas_.copy(area);
+        DrawItemOnto(patch, it, area.topLeft());
+        if (it.type == DrawItem::Type::kEraserFree) {
+            // 擦除后是透明像素，先把这块恢复成 canvas_ 下面的背景 + 遮罩
+            const QRect widgetArea = painter.transform().mapRect(area);
+            painter.save();
+            painter.resetTransform();
+            painter.drawPixmap(widgetArea, background_, widgetArea);
+            painter.fillRect(widgetArea, QColor(0, 0, 0, 120));
+            painter.restore();
         }
+        painter.drawPixmap(area.topLeft(), patch);
+        break;
     }
-    else if (item.type == DrawItem::Type::kArrow) {
-        itemRect = QRect(item.p1.toPoint(), item.p2.toPoint()).normalized();
+    default:
+        break;
+    }
+
+    painter.restore();
+}
+
+QRect ScreenshotOverlay::ItemBounds(const DrawItem& item) {
+    int margin = item.stroke_width / 2 + 2;
+    QRect r;
+    switch (item.type) {
+    case DrawItem::Type::kMosaic:
+    case DrawItem::Type::kBlur:
+        // 像素效果严格限制在 rect 内
+        return item.rect.normalized();
+    case DrawItem::Type::kArrow:
+        r = QRect(item.p1.toPoint(), item.p2.toPoint()).normalized();
+        margin += qMax(12, item.stroke_width * 4);  // 箭头长度，见 ShapeDrawer::DrawArrow
+        break;
+    case DrawItem::Type::kPen:
+    case DrawItem::Type::kEraserFree:
+        if (item.path.isEmpty()) return QRect();
+        r = QPolygon(item.path).boundingRect();
+        break;
+    default:
+        r = item.rect.normalized();
+        break;
     }
+    return r.adjusted(-margin, -margin, margin, margin);
+}
 
-    QRect eraseBounds;
-    // compute bounding box of eraser path
-    int minx = eraserPath[0].x(), miny = eraserPath[0].y();
-    int maxx = minx, maxy = miny;
-    for (const QPoint& p : eraserPath) {
-        minx = std::min(minx, p.x()); miny = std::min(miny, p.y());
-        maxx = std::max(maxx, p.x()); maxy = std::max(maxy, p.y());
+void ScreenshotOverlay::CommitItem(DrawItem item) {
+    item.id = next_item_id_++;
+    items_.push_back(item);
+    IndexItem(item);
+    AppendItemToCanvas(item);
+
+    EditCommand cmd;
+    cmd.kind = EditCommand::Kind::kAdd;
+    cmd.indices.append(items_.size() - 1);
+    cmd.after.append(item);
+    PushCommand(std::move(cmd));
+}
+
+void ScreenshotOverlay::IndexItem(const DrawItem& item) {
+    const qreal halfWidth = item.stroke_width / 2.0;
+    switch (item.type) {
+    case DrawItem::Type::kPen: {
+        QVector<QPointF> points;
+        points.reserve(item.path.size());
+        for (const QPoint& p : item.path) points.append(p);
+        hit_index_.insertPolyline(item.id, points, halfWidth);
+        break;
     }
-    eraseBounds = QRect(QPoint(minx - eraserRadius, miny - eraserRadius),
-        QPoint(maxx + eraserRadius, maxy + eraserRadius));
+    case DrawItem::Type::kArrow:
+        hit_index_.insertPolyline(item.id, { item.p1, item.p2 }, halfWidth);
+        break;
+    case DrawItem::Type::kRect:
+    case DrawItem::Type::kEllipse:
+    case DrawItem::Type::kMosaic:
+    case DrawItem::Type::kBlur:
+        // 区域类对象：擦除轨迹碰到其范围即视为命中
+        hit_index_.insertArea(item.id, ItemBounds(item));
+        break;
+    default:
+        // 自由像素擦除不是可擦除的对象
+        break;
+    }
+}
 
-    if (itemRect.intersects(eraseBounds)) return true;
+// 基于网格索引的 hit-test：只检查擦除轨迹经过的网格，再做线段-线段的精确距离判断
+QVector<int> ScreenshotOverlay::HitTestItems(const QVector<QPoint>& eraserPath, int eraserRadius) const {
+    QVector<int> result;
+    const QSet<quint64> hits = hit_index_.query(eraserPath, eraserRadius);
+    if (hits.isEmpty()) return result;
 
-    // 更精确：对 pen 路径点检测到擦除路径的最小距离
-    if (item.type == DrawItem::Type::kPen && !item.path.isEmpty()) {
-        for (const QPoint& p1 : item.path) {
-            for (const QPoint& p2 : eraserPath) {
-                int dx = p1.x() - p2.x();
-                int dy = p1.y() - p2.y();
-                if (dx * dx + dy * dy <= eraserRadius * eraserRadius) return true;
-            }
+    for (int i = 0; i < items_.size(); ++i) {
+        if (hits.contains(items_[i].id)) {
+            result.append(i);
         }
     }
-
-    return false;
+    return result;
 }
 void ScreenshotOverlay::DoHoverInspect(const QPoint& pos)
 {
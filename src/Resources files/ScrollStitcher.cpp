@@ -0,0 +1,692 @@
+#include "ScrollStitcher.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    constexpr int kMaxCandidates = 4;   // 粗搜保留的候选偏移数
+    constexpr int kMinOverlapRows = 8;  // 重叠区至少要有这么多有效行才算数
+    constexpr int kVerifyRows = 8;      // 分段抓取时，新内容上方用来校验衔接的行数
+
+    QImage ToRgb32(const QImage& image)
+    {
+        if (image.format() == QImage::Format_RGB32 ||
+            image.format() == QImage::Format_ARGB32 ||
+            image.format() == QImage::Format_ARGB32_Premultiplied) {
+            return image;
+        }
+        return image.convertToFormat(QImage::Format_RGB32);
+    }
+
+    // ---- 2D 平移估计（全景模式）----
+    constexpr int kPatchSize = 16;        // 锚点块边长
+    constexpr int kAnchorStep = 24;       // 参考帧上取锚点的网格间距
+    constexpr int kVerifyChunk = 64;      // 校验时每行按多少列分段比较
+    constexpr int kMinVerifyChunks = 16;  // 重叠区至少要有这么多有效段才算数
+    constexpr quint64 kHashBaseX = 1000003ull;
+    constexpr quint64 kHashBaseY = 998244353ull;
+
+    quint64 PixelValue(QRgb p)
+    {
+        return quint64(p & 0x00FFFFFF) + 1;   // 忽略 alpha，+1 避免黑色像素对哈希没有贡献
+    }
+
+    quint64 HashPow(quint64 base, int exp)
+    {
+        quint64 r = 1;
+        for (int i = 0; i < exp; ++i) r *= base;
+        return r;
+    }
+
+    // 与 estimateShift 里滚动计算的窗口哈希一致：先按行、再按列做多项式哈希（模 2^64）
+    quint64 PatchHash(const QImage& img, int x, int y)
+    {
+        quint64 hy = 0;
+        for (int j = 0; j < kPatchSize; ++j) {
+            const QRgb* line = reinterpret_cast<const QRgb*>(img.constScanLine(y + j));
+            quint64 hx = 0;
+            for (int i = 0; i < kPatchSize; ++i) {
+                hx = hx * kHashBaseX + PixelValue(line[x + i]);
+            }
+            hy = hy * kHashBaseY + hx;
+        }
+        return hy;
+    }
+
+    bool IsFlatPatch(const QImage& img, int x, int y)
+    {
+        const QRgb first = reinterpret_cast<const QRgb*>(img.constScanLine(y))[x] & 0x00FFFFFF;
+        for (int j = 0; j < kPatchSize; ++j) {
+            const QRgb* line = reinterpret_cast<const QRgb*>(img.constScanLine(y + j));
+            for (int i = 0; i < kPatchSize; ++i) {
+                if ((line[x + i] & 0x00FFFFFF) != first) return false;
+            }
+        }
+        return true;
+    }
+
+    bool IsFlatSpan(const QRgb* p, int n)
+    {
+        for (int i = 1; i < n; ++i) {
+            if (p[i] != p[0]) return false;
+        }
+        return true;
+    }
+
+    // cur(x, y) == prev(x + dx, y + dy) 的匹配率：重叠区每行切成 kVerifyChunk 列一段比较，
+    // 两边都一样且是纯色的段没有信息量，不计入
+    double VerifyShift(const QImage& prev, const QImage& cur, int dx, int dy)
+    {
+        const int w = cur.width();
+        const int h = cur.height();
+        const int x0 = qMax(0, -dx);
+        const int x1 = qMin(w, w - dx);
+        const int y0 = qMax(0, -dy);
+        const int y1 = qMin(h, h - dy);
+        if (x1 - x0 < kPatchSize || y1 - y0 < kPatchSize) {
+            return 0;
+        }
+
+        int valid = 0;
+        int same = 0;
+        const int span = x1 - x0;
+        for (int y = y0; y < y1; ++y) {
+            const QRgb* a = reinterpret_cast<const QRgb*>(cur.constScanLine(y)) + x0;
+            const QRgb* b = reinterpret_cast<const QRgb*>(prev.constScanLine(y + dy)) + x0 + dx;
+            for (int c = 0; c < span; c += kVerifyChunk) {
+                const int n = qMin(kVerifyChunk, span - c);
+                if (memcmp(a + c, b + c, size_t(n) * sizeof(QRgb)) != 0) {
+                    ++valid;
+                }
+                else if (!IsFlatSpan(a + c, n)) {
+                    ++valid;
+                    ++same;
+                }
+            }
+        }
+        return valid >= kMinVerifyChunks ? double(same) / valid : 0;
+    }
+
+} // namespace
+
+ScrollStitcher::Fingerprint ScrollStitcher::fingerprintOf(const QImage& frame)
+{
+    Fingerprint fp;
+    if (frame.isNull()) {
+        return fp;
+    }
+
+    const QImage img = ToRgb32(frame);
+    const int w = img.width();
+    const int h = img.height();
+    fp.size = img.size();
+    fp.rows.resize(h);
+    fp.flat.resize(h);
+    fp.luma.resize(qsizetype(h) * kLumaBins);
+
+    // 亮度轮廓只需要粗略值，每隔几个像素取一个
+    const int lumaStep = qMax(1, w / (kLumaBins * 8));
+
+    for (int y = 0; y < h; ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(img.constScanLine(y));
+        const quint32 first = line[0] & 0x00FFFFFF;
+
+        // FNV-1a 的变体：一次吃两个像素
+        quint64 hash = 14695981039346656037ull;
+        quint32 diff = 0;
+        int x = 0;
+        for (; x + 1 < w; x += 2) {
+            const quint32 a = line[x] & 0x00FFFFFF;
+            const quint32 b = line[x + 1] & 0x00FFFFFF;
+            diff |= (a ^ first) | (b ^ first);
+            hash = (hash ^ ((quint64(a) << 32) | b)) * 1099511628211ull;
+        }
+        if (x < w) {
+            const quint32 a = line[x] & 0x00FFFFFF;
+            diff |= a ^ first;
+            hash = (hash ^ a) * 1099511628211ull;
+        }
+        fp.rows[y] = hash;
+        fp.flat[y] = (diff == 0);
+
+        quint8* luma = fp.luma.data() + qsizetype(y) * kLumaBins;
+        for (int bin = 0; bin < kLumaBins; ++bin) {
+            const int x0 = bin * w / kLumaBins;
+            const int x1 = qMax(x0 + 1, (bin + 1) * w / kLumaBins);
+            quint32 sum = 0;
+            quint32 n = 0;
+            for (int xi = x0; xi < x1 && xi < w; xi += lumaStep) {
+                const QRgb p = line[xi];
+                sum += (qRed(p) * 77 + qGreen(p) * 150 + qBlue(p) * 29) >> 8;
+                ++n;
+            }
+            luma[bin] = quint8(n ? sum / n : 0);
+        }
+    }
+    return fp;
+}
+
+bool ScrollStitcher::isChanged(const Fingerprint& prev, const Fingerprint& cur)
+{
+    if (prev.size != cur.size) {
+        return true;
+    }
+    if (prev.rows == cur.rows) {
+        return false;   // 像素完全一致，最常见的“没动”情况
+    }
+
+    qint64 diff = 0;
+    for (qsizetype i = 0; i < cur.luma.size(); ++i) {
+        diff += qAbs(int(cur.luma[i]) - int(prev.luma[i]));
+    }
+    return double(diff) / qMax<qsizetype>(1, cur.luma.size()) > kChangeThreshold;
+}
+
+ScrollStitcher::Match ScrollStitcher::estimateOffset(const Fingerprint& prev, const Fingerprint& cur)
+{
+    Match best;
+    const QVector<quint64>& prevRows = prev.rows;
+    const QVector<bool>& prevFlat = prev.flat;
+    const QVector<quint64>& curRows = cur.rows;
+    const QVector<bool>& curFlat = cur.flat;
+    const int h = prevRows.size();
+    const int c = curRows.size();   // cur 可以只是一帧顶部的探针条
+    if (h == 0 || c == 0 || c > h || cur.size.width() != prev.size.width()) {
+        return best;
+    }
+
+    // ---- 粗搜：哈希唯一的有效行投票 ----
+    QHash<quint64, int> rowOf;   // hash -> prev 中的行号，出现多次记为 -1
+    rowOf.reserve(h);
+    for (int y = 0; y < h; ++y) {
+        if (prevFlat[y]) continue;
+        auto it = rowOf.find(prevRows[y]);
+        if (it == rowOf.end()) rowOf.insert(prevRows[y], y);
+        else it.value() = -1;
+    }
+
+    QHash<int, int> votes;
+    for (int y = 0; y < c; ++y) {
+        if (curFlat[y]) continue;
+        const int py = rowOf.value(curRows[y], -1);
+        if (py >= y) {
+            ++votes[py - y];
+        }
+    }
+
+    QVector<QPair<int, int>> ranked;   // (票数, 偏移)
+    ranked.reserve(votes.size());
+    for (auto it = votes.cbegin(); it != votes.cend(); ++it) {
+        ranked.push_back({ it.value(), it.key() });
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<int, int>& a, const QPair<int, int>& b) {
+        return a.first > b.first;
+        });
+
+    QVector<int> candidates{ 0 };   // 不滚动总是候选
+    for (int i = 0; i < ranked.size() && candidates.size() <= kMaxCandidates; ++i) {
+        if (!candidates.contains(ranked[i].second)) {
+            candidates.push_back(ranked[i].second);
+        }
+    }
+
+    // ---- 精搜：逐行比较重叠区 ----
+    for (int d : candidates) {
+        int valid = 0;
+        int same = 0;
+        for (int y = 0; y < c && y + d < h; ++y) {
+            if (curFlat[y] && prevFlat[y + d]) continue;   // 两边都是纯色，没有信息量
+            ++valid;
+            if (curRows[y] == prevRows[y + d]) ++same;
+        }
+        if (valid < qMin(kMinOverlapRows, c)) continue;
+
+        const double confidence = double(same) / valid;
+        if (confidence > best.confidence ||
+            (confidence == best.confidence && d < best.offset)) {
+            best.offset = d;
+            best.confidence = confidence;
+        }
+    }
+    best.matched = best.confidence >= kMinConfidence;
+    return best;
+}
+
+ScrollStitcher::Match ScrollStitcher::estimateShift(const QImage& prevImage, const QImage& curImage)
+{
+    Match best;
+    if (prevImage.isNull() || prevImage.size() != curImage.size() ||
+        prevImage.width() < kPatchSize || prevImage.height() < kPatchSize) {
+        return best;
+    }
+
+    const QImage prev = ToRgb32(prevImage);
+    const QImage cur = ToRgb32(curImage);
+    const int w = prev.width();
+    const int h = prev.height();
+
+    // ---- 锚点：参考帧上按网格取非纯色小块，块哈希唯一的才用（重复的字形会造成歧义）----
+    QHash<quint64, QPoint> anchors;
+    for (int ay = kAnchorStep / 2; ay + kPatchSize <= h; ay += kAnchorStep) {
+        for (int ax = kAnchorStep / 2; ax + kPatchSize <= w; ax += kAnchorStep) {
+            if (IsFlatPatch(prev, ax, ay)) continue;
+            const quint64 hash = PatchHash(prev, ax, ay);
+            auto it = anchors.find(hash);
+            if (it == anchors.end()) anchors.insert(hash, QPoint(ax, ay));
+            else it.value() = QPoint(-1, -1);
+        }
+    }
+
+    // 哈希高 16 位做一张位图，绝大多数窗口不用查 QHash
+    QVector<quint64> filter(1 << 10, 0);
+    for (auto it = anchors.cbegin(); it != anchors.cend(); ++it) {
+        const quint64 bit = it.key() >> 48;
+        filter[int(bit >> 6)] |= 1ull << (bit & 63);
+    }
+
+    // ---- 投票：在当前帧上滚动计算所有 kPatchSize 见方窗口的哈希，命中锚点就给 (dx, dy) 投一票 ----
+    const int cols = w - kPatchSize + 1;
+    const quint64 powX = HashPow(kHashBaseX, kPatchSize - 1);
+    const quint64 powY = HashPow(kHashBaseY, kPatchSize - 1);
+    QVector<quint64> ring(qsizetype(kPatchSize) * cols);   // 最近 kPatchSize 行的行内窗口哈希
+    QVector<quint64> rowHash(cols);
+    QVector<quint64> column(cols, 0);                      // 纵向滚动累加的窗口哈希
+    QHash<quint64, int> votes;
+
+    for (int y = 0; y < h; ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(cur.constScanLine(y));
+        quint64 hx = 0;
+        for (int x = 0; x < kPatchSize; ++x) {
+            hx = hx * kHashBaseX + PixelValue(line[x]);
+        }
+        rowHash[0] = hx;
+        for (int x = 1; x < cols; ++x) {
+            hx = (hx - PixelValue(line[x - 1]) * powX) * kHashBaseX + PixelValue(line[x + kPatchSize - 1]);
+            rowHash[x] = hx;
+        }
+
+        quint64* slot = ring.data() + qsizetype(y % kPatchSize) * cols;
+        for (int x = 0; x < cols; ++x) {
+            // slot 里还是 y - kPatchSize 行的值，正好是要移出窗口的那一行
+            const quint64 out = y >= kPatchSize ? slot[x] * powY : 0;
+            column[x] = (column[x] - out) * kHashBaseY + rowHash[x];
+            slot[x] = rowHash[x];
+        }
+
+        if (y < kPatchSize - 1) continue;
+        const int top = y - kPatchSize + 1;
+        for (int x = 0; x < cols; ++x) {
+            const quint64 bit = column[x] >> 48;
+            if (!(filter[int(bit >> 6)] & (1ull << (bit & 63)))) continue;
+            const QPoint a = anchors.value(column[x], QPoint(-1, -1));
+            if (a.x() < 0) continue;
+            // 当前帧 (x, top) 处的内容在参考帧 (a.x, a.y)：cur(x, y) == prev(x + dx, y + dy)
+            ++votes[(quint64(quint32(a.x() - x)) << 32) | quint32(a.y() - top)];
+        }
+    }
+
+    QVector<QPair<int, QPoint>> ranked;   // (票数, 偏移)
+    ranked.reserve(votes.size());
+    for (auto it = votes.cbegin(); it != votes.cend(); ++it) {
+        ranked.push_back({ it.value(), QPoint(int(quint32(it.key() >> 32)), int(quint32(it.key()))) });
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<int, QPoint>& a, const QPair<int, QPoint>& b) {
+        return a.first > b.first;
+        });
+
+    QVector<QPoint> candidates{ QPoint(0, 0) };
+    for (int i = 0; i < ranked.size() && candidates.size() <= kMaxCandidates; ++i) {
+        if (!candidates.contains(ranked[i].second)) {
+            candidates.push_back(ranked[i].second);
+        }
+    }
+
+    // ---- 校验：重叠区逐行分段比较，动画 / 光标只影响少数几段 ----
+    for (const QPoint& d : candidates) {
+        const double confidence = VerifyShift(prev, cur, d.x(), d.y());
+        const int dist = qAbs(d.x()) + qAbs(d.y());
+        const int bestDist = qAbs(best.offsetX) + qAbs(best.offset);
+        if (confidence > best.confidence || (confidence == best.confidence && dist < bestDist)) {
+            best.offsetX = d.x();
+            best.offset = d.y();
+            best.confidence = confidence;
+        }
+    }
+    best.matched = best.confidence >= kMinConfidence;
+    return best;
+}
+
+void ScrollStitcher::reset()
+{
+    prev_ = Fingerprint();
+    prevFrame_ = QImage();
+    pendingFirst_ = QImage();
+    footerImage_ = QImage();
+    headerRows_ = 0;
+    footerRows_ = 0;
+    stickyKnown_ = false;
+    panorama_ = false;
+    framePos_ = QPoint();
+}
+
+ScrollStitcher::Fingerprint ScrollStitcher::sliceRows(const Fingerprint& fp, int from, int count)
+{
+    Fingerprint out;
+    out.size = QSize(fp.size.width(), count);
+    out.rows = fp.rows.mid(from, count);
+    out.flat = fp.flat.mid(from, count);
+    out.luma = fp.luma.mid(qsizetype(from) * kLumaBins, qsizetype(count) * kLumaBins);
+    return out;
+}
+
+void ScrollStitcher::detectSticky(const Fingerprint& prev, const Fingerprint& cur, int& header, int& footer)
+{
+    const int h = cur.rows.size();
+    header = 0;
+    footer = 0;
+
+    // 从上往下 / 从下往上，位置不变的连续行
+    while (header < h && prev.rows[header] == cur.rows[header]) ++header;
+    while (footer < h - header && prev.rows[h - 1 - footer] == cur.rows[h - 1 - footer]) ++footer;
+
+    // 靠内侧的纯色行不算（可能只是内容区的空白），吸顶 / 吸底区域至少要有一行有内容
+    while (header > 0 && cur.flat[header - 1]) --header;
+    while (footer > 0 && cur.flat[h - footer]) --footer;
+
+    // 固定区域太大时，剩下的滚动区不足以可靠匹配，宁可不识别
+    if (header + footer > h / 2) {
+        header = 0;
+        footer = 0;
+    }
+}
+
+QImage ScrollStitcher::stackRows(const QImage& top, const QImage& bottom)
+{
+    if (top.isNull()) return bottom;
+    if (bottom.isNull()) return top;
+
+    const QImage b = bottom.format() == top.format() ? bottom : bottom.convertToFormat(top.format());
+    QImage out(top.width(), top.height() + b.height(), top.format());
+    const qsizetype bytes = qMin(out.bytesPerLine(), top.bytesPerLine());
+    for (int y = 0; y < top.height(); ++y) {
+        memcpy(out.scanLine(y), top.constScanLine(y), size_t(bytes));
+    }
+    for (int y = 0; y < b.height(); ++y) {
+        memcpy(out.scanLine(top.height() + y), b.constScanLine(y), size_t(bytes));
+    }
+    return out;
+}
+
+QImage ScrollStitcher::flushFirstFrame(const QImage& newRows)
+{
+    // 第一次滚动：吸顶 / 吸底区域已经确定（或确定没有），输出第一帧（不含吸底区域）
+    const int h = pendingFirst_.height();
+    const QImage head = pendingFirst_.copy(0, 0, pendingFirst_.width(), h - footerRows_);
+    if (footerRows_ > 0) {
+        footerImage_ = pendingFirst_.copy(0, h - footerRows_, pendingFirst_.width(), footerRows_);
+    }
+    pendingFirst_ = QImage();
+    stickyKnown_ = true;
+    return stackRows(head, newRows);
+}
+
+QImage ScrollStitcher::finish()
+{
+    QImage out;
+    if (!pendingFirst_.isNull()) {
+        out = pendingFirst_;   // 一直没滚动：整帧就是结果
+    }
+    else {
+        out = footerImage_;    // 吸底区域放在最后，只出现一次
+    }
+    pendingFirst_ = QImage();
+    footerImage_ = QImage();
+    return out;
+}
+
+ScrollStitcher::Result ScrollStitcher::push(const QImage& frame, const Fingerprint& fingerprint)
+{
+    Result result;
+    if (frame.isNull() || fingerprint.isNull()) {
+        return result;
+    }
+
+    if (prev_.isNull() || fingerprint.size != prev_.size) {
+        // 第一帧（或尺寸变化）：先把上一段剩下的部分输出，新帧留到第一次滚动时再输出
+        result.changed = true;
+        result.band = finish();
+        headerRows_ = 0;
+        footerRows_ = 0;
+        stickyKnown_ = false;
+        panorama_ = false;
+        pendingFirst_ = frame;
+        prevFrame_ = frame;
+        prev_ = fingerprint;
+        return result;
+    }
+
+    if (panorama_) {
+        return pushPanorama(frame, fingerprint);
+    }
+
+    if (!isChanged(prev_, fingerprint)) {
+        return result;
+    }
+    result.changed = true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int w = frame.width();
+    const int h = frame.height();
+
+    // 第一次变化时识别吸顶 / 吸底：位置不变的行，且其余部分确实在滚动
+    int header = headerRows_;
+    int footer = footerRows_;
+    if (!stickyKnown_) {
+        detectSticky(prev_, fingerprint, header, footer);
+        if (header + footer > 0) {
+            const int rows = h - header - footer;
+            const Match m = estimateOffset(sliceRows(prev_, header, rows), sliceRows(fingerprint, header, rows));
+            if (m.matched && m.offset > 0) {
+                headerRows_ = header;
+                footerRows_ = footer;
+                result.stickyChanged = true;
+                qDebug() << "[LongShot] stitch: sticky header =" << header << "footer =" << footer << "rows";
+            }
+        }
+    }
+
+    // 只在吸顶和吸底之间的滚动区里匹配
+    const int regionRows = h - headerRows_ - footerRows_;
+    result.match = estimateOffset(sliceRows(prev_, headerRows_, regionRows),
+        sliceRows(fingerprint, headerRows_, regionRows));
+
+    // 第一次滚动就找不到垂直方向的重叠：看看是不是横向 / 斜向平移，是的话本次截图改为全景模式
+    if (!pendingFirst_.isNull() && !result.match.matched) {
+        const int rows = h - header - footer;
+        const Match shift = estimateShift(prevFrame_.copy(0, header, w, rows), frame.copy(0, header, w, rows));
+        if (shift.matched && shift.offsetX != 0) {
+            return startPanorama(frame, fingerprint, shift, header, footer);
+        }
+    }
+
+    QImage newRows;
+    if (result.match.matched) {
+        if (result.match.offset > 0) {
+            newRows = frame.copy(0, h - footerRows_ - result.match.offset, w, result.match.offset);
+        }
+    }
+    else {
+        // 找不到可信的重叠（跳页 / 大幅变化），整个滚动区追加，宁可重复也不丢内容
+        qDebug() << "[LongShot] stitch: no reliable overlap, confidence ="
+            << result.match.confidence << ", appending full frame";
+        result.overlapLost = pendingFirst_.isNull();
+        newRows = frame.copy(0, headerRows_, w, regionRows);
+    }
+
+    if (!pendingFirst_.isNull() && !newRows.isNull()) {
+        newRows = flushFirstFrame(newRows);
+    }
+    result.band = newRows;
+
+    qDebug() << "[LongShot] stitch: offset =" << result.match.offset
+        << "confidence =" << result.match.confidence
+        << "in" << timer.nsecsElapsed() / 1000 << "us";
+
+    prev_ = fingerprint;
+    prevFrame_ = frame;
+    return result;
+}
+
+QImage ScrollStitcher::regionOf(const QImage& frame) const
+{
+    return frame.copy(0, headerRows_, frame.width(), frame.height() - headerRows_ - footerRows_);
+}
+
+ScrollStitcher::Result ScrollStitcher::startPanorama(const QImage& frame, const Fingerprint& fingerprint,
+    const Match& shift, int header, int footer)
+{
+    // 吸顶 / 吸底（工具栏、状态栏）在全景里没有固定位置，不拼进结果
+    panorama_ = true;
+    stickyKnown_ = true;
+    headerRows_ = header;
+    footerRows_ = footer;
+    framePos_ = QPoint(shift.offsetX, shift.offset);
+
+    Result result;
+    result.changed = true;
+    result.match = shift;
+    result.panoramaStarted = true;
+    result.placements.push_back({ QPoint(0, 0), regionOf(pendingFirst_) });
+    result.placements.push_back({ framePos_, regionOf(frame) });
+    qDebug() << "[LongShot] stitch: 2D pan detected, dx =" << shift.offsetX << "dy =" << shift.offset
+        << ", switching to panorama";
+
+    pendingFirst_ = QImage();
+    prev_ = fingerprint;
+    prevFrame_ = frame;
+    return result;
+}
+
+ScrollStitcher::Result ScrollStitcher::pushPanorama(const QImage& frame, const Fingerprint& fingerprint)
+{
+    Result result;
+    if (!isChanged(prev_, fingerprint)) {
+        return result;
+    }
+    result.changed = true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QImage cur = regionOf(frame);
+    result.match = estimateShift(regionOf(prevFrame_), cur);
+    if (!result.match.matched) {
+        // 不知道这一帧该放在哪里：丢掉它并保留参考帧，用户移回有重叠的位置后还能接上
+        qDebug() << "[LongShot] stitch(panorama): no reliable overlap, confidence ="
+            << result.match.confidence << ", frame dropped";
+        result.overlapLost = true;
+        return result;
+    }
+
+    if (result.match.offsetX != 0 || result.match.offset != 0) {
+        framePos_ += QPoint(result.match.offsetX, result.match.offset);
+        result.placements.push_back({ framePos_, cur });
+    }
+    qDebug() << "[LongShot] stitch(panorama): dx =" << result.match.offsetX
+        << "dy =" << result.match.offset
+        << "confidence =" << result.match.confidence
+        << "in" << timer.nsecsElapsed() / 1000 << "us";
+
+    prev_ = fingerprint;
+    prevFrame_ = frame;
+    return result;
+}
+
+ScrollStitcher::Result ScrollStitcher::pushBand(const QImage& probe, const QImage& tail)
+{
+    Result result;
+    const int w = prev_.size.width();
+    const int h = prev_.size.height();
+    const int regionRows = h - headerRows_ - footerRows_;
+    // probe 从选区顶部开始（含吸顶区域），tail 一直到选区底部（含吸底区域）；全景模式只接受整帧
+    if (prev_.isNull() || panorama_ || probe.isNull() || tail.isNull() ||
+        probe.width() != w || tail.width() != w ||
+        probe.height() <= headerRows_ || probe.height() - headerRows_ >= regionRows ||
+        tail.height() <= footerRows_ || tail.height() > h) {
+        result.needFullFrame = true;
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 探针条（滚动区顶部几行）在参考帧里的位置就是滚动量
+    const Fingerprint probeFp = fingerprintOf(probe);
+    const Fingerprint probeRegion = sliceRows(probeFp, headerRows_, probe.height() - headerRows_);
+    if (std::equal(probeRegion.rows.cbegin(), probeRegion.rows.cend(), prev_.rows.cbegin() + headerRows_)) {
+        return result;   // 探针没动，视为静止
+    }
+    result.changed = true;
+
+    // 第一帧还没输出时需要整帧来确定吸顶 / 吸底
+    if (!pendingFirst_.isNull()) {
+        result.needFullFrame = true;
+        return result;
+    }
+
+    const Fingerprint refRegion = sliceRows(prev_, headerRows_, regionRows);
+    result.match = estimateOffset(refRegion, probeRegion);
+    if (!result.match.matched) {
+        result.needFullFrame = true;
+        return result;
+    }
+    if (result.match.offset == 0) {
+        result.changed = false;
+        return result;
+    }
+
+    // tail 去掉吸底区域后要覆盖新内容和上方的校验行
+    const int d = result.match.offset;
+    const int t = tail.height() - footerRows_;
+    if (t < d + kVerifyRows) {
+        result.needFullFrame = true;
+        return result;
+    }
+
+    // 校验：新内容上方的几行应该正好是参考帧滚动区的最后几行，否则两次抓取之间又滚动了
+    const Fingerprint tailFp = fingerprintOf(tail);
+    const int refBottom = h - footerRows_;
+    for (int i = 0; i < kVerifyRows; ++i) {
+        if (tailFp.rows[t - d - kVerifyRows + i] != prev_.rows[refBottom - kVerifyRows + i]) {
+            result.needFullFrame = true;
+            return result;
+        }
+    }
+
+    result.band = tail.copy(0, t - d, w, d);
+
+    // 参考帧的滚动区整体上移 d 行，底部补上新内容的指纹；吸顶 / 吸底不变
+    Fingerprint next;
+    next.size = prev_.size;
+    const Fingerprint head = sliceRows(prev_, 0, headerRows_);
+    const Fingerprint kept = sliceRows(prev_, headerRows_ + d, regionRows - d);
+    const Fingerprint added = sliceRows(tailFp, t - d, d);
+    const Fingerprint foot = sliceRows(prev_, refBottom, footerRows_);
+    for (const Fingerprint* part : { &head, &kept, &added, &foot }) {
+        next.rows += part->rows;
+        next.flat += part->flat;
+        next.luma += part->luma;
+    }
+    prev_ = std::move(next);
+
+    qDebug() << "[LongShot] stitch(band): offset =" << d
+        << "confidence =" << result.match.confidence
+        << "in" << timer.nsecsElapsed() / 1000 << "us";
+    return result;
+}
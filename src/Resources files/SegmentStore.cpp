@@ -0,0 +1,113 @@
+#include "SegmentStore.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QDir>
+#include <QTemporaryFile>
+#include <cstring>
+
+SegmentStore::SegmentStore(qint64 memoryBudget)
+    : memoryBudget_(memoryBudget)
+{
+}
+
+SegmentStore::~SegmentStore() = default;
+
+void SegmentStore::clear()
+{
+    entries_.clear();
+    file_.reset();
+    memoryBytes_ = 0;
+    diskBytes_ = 0;
+    totalHeight_ = 0;
+    firstResident_ = 0;
+}
+
+void SegmentStore::setMemoryBudget(qint64 bytes)
+{
+    memoryBudget_ = qMax<qint64>(0, bytes);
+    spill();
+}
+
+void SegmentStore::append(const QImage& segment)
+{
+    if (segment.isNull()) {
+        return;
+    }
+
+    Entry entry;
+    entry.image = segment;
+    entry.width = segment.width();
+    entry.height = segment.height();
+    entry.format = segment.format();
+    memoryBytes_ += segment.sizeInBytes();
+    totalHeight_ += segment.height();
+    entries_.push_back(std::move(entry));
+
+    spill();
+}
+
+void SegmentStore::spill()
+{
+    // 最新一段不落盘
+    while (memoryBytes_ > memoryBudget_ && firstResident_ < entries_.size() - 1) {
+        if (!spillEntry(entries_[firstResident_])) {
+            return;   // 写盘失败就继续占内存，不丢数据
+        }
+        ++firstResident_;
+    }
+}
+
+bool SegmentStore::spillEntry(Entry& entry)
+{
+    if (!file_) {
+        file_ = std::make_unique<QTemporaryFile>(QDir::tempPath() + "/qtscreenshot-longshot-XXXXXX.bin");
+        if (!file_->open()) {
+            qDebug() << "[SegmentStore] failed to open temp file:" << file_->errorString();
+            file_.reset();
+            return false;
+        }
+    }
+
+    // 屏幕内容压缩率很高，用最快的压缩级别即可
+    const QByteArray raw = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(entry.image.constBits()), entry.image.sizeInBytes());
+    const QByteArray packed = qCompress(raw, 1);
+
+    const qint64 offset = file_->size();
+    if (!file_->seek(offset) || file_->write(packed) != packed.size()) {
+        qDebug() << "[SegmentStore] failed to write segment:" << file_->errorString();
+        return false;
+    }
+
+    memoryBytes_ -= entry.image.sizeInBytes();
+    diskBytes_ += packed.size();
+    entry.fileOffset = offset;
+    entry.fileSize = packed.size();
+    entry.image = QImage();
+    return true;
+}
+
+QImage SegmentStore::at(int index) const
+{
+    const Entry& entry = entries_[index];
+    if (!entry.image.isNull()) {
+        return entry.image;
+    }
+    if (!file_ || entry.fileOffset < 0) {
+        return QImage();
+    }
+
+    if (!file_->seek(entry.fileOffset)) {
+        return QImage();
+    }
+    const QByteArray raw = qUncompress(file_->read(entry.fileSize));
+
+    QImage image(entry.width, entry.height, entry.format);
+    if (image.isNull() || raw.size() != image.sizeInBytes()) {
+        qDebug() << "[SegmentStore] corrupted segment" << index;
+        return QImage();
+    }
+    memcpy(image.bits(), raw.constData(), size_t(raw.size()));
+    return image;
+}
@@ -0,0 +1,199 @@
+#include "SpatialGrid.h"
+
+#include <QRect>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    qreal PointSegmentDistance(const QPointF& p, const QLineF& s)
+    {
+        const QPointF d = s.p2() - s.p1();
+        const qreal len2 = d.x() * d.x() + d.y() * d.y();
+        qreal t = 0;
+        if (len2 > 0) {
+            t = ((p.x() - s.x1()) * d.x() + (p.y() - s.y1()) * d.y()) / len2;
+            t = std::clamp<qreal>(t, 0, 1);
+        }
+        const QPointF q = s.p1() + d * t;
+        return std::hypot(p.x() - q.x(), p.y() - q.y());
+    }
+
+    QRectF SegmentBounds(const QLineF& s, qreal margin)
+    {
+        return QRectF(s.p1(), s.p2()).normalized().adjusted(-margin, -margin, margin, margin);
+    }
+
+} // namespace
+
+SpatialGrid::SpatialGrid(int cellSize)
+    : cell_size_(qMax(8, cellSize))
+{
+}
+
+void SpatialGrid::clear()
+{
+    shapes_.clear();
+    cells_.clear();
+}
+
+quint64 SpatialGrid::cellKey(int cx, int cy)
+{
+    return (quint64(quint32(cx)) << 32) | quint32(cy);
+}
+
+QRect SpatialGrid::cellRange(const QRectF& r) const
+{
+    const int x0 = int(std::floor(r.left() / cell_size_));
+    const int y0 = int(std::floor(r.top() / cell_size_));
+    const int x1 = int(std::floor(r.right() / cell_size_));
+    const int y1 = int(std::floor(r.bottom() / cell_size_));
+    return QRect(QPoint(x0, y0), QPoint(x1, y1));
+}
+
+void SpatialGrid::registerRef(const QRectF& bounds, const Ref& ref)
+{
+    const QRect cr = cellRange(bounds);
+    for (int cy = cr.top(); cy <= cr.bottom(); ++cy) {
+        for (int cx = cr.left(); cx <= cr.right(); ++cx) {
+            cells_[cellKey(cx, cy)].push_back(ref);
+        }
+    }
+}
+
+void SpatialGrid::insertPolyline(quint64 key, const QVector<QPointF>& points, qreal halfWidth)
+{
+    if (points.isEmpty()) {
+        return;
+    }
+    remove(key);
+
+    Shape shape;
+    shape.halfWidth = halfWidth;
+    if (points.size() == 1) {
+        shape.segments.push_back(QLineF(points[0], points[0]));
+    }
+    for (int i = 1; i < points.size(); ++i) {
+        shape.segments.push_back(QLineF(points[i - 1], points[i]));
+    }
+
+    for (int i = 0; i < shape.segments.size(); ++i) {
+        registerRef(SegmentBounds(shape.segments[i], halfWidth), Ref{ key, i });
+    }
+    shapes_.insert(key, std::move(shape));
+}
+
+void SpatialGrid::insertArea(quint64 key, const QRectF& rect)
+{
+    if (rect.isEmpty()) {
+        return;
+    }
+    remove(key);
+
+    Shape shape;
+    shape.isArea = true;
+    shape.area = rect.normalized();
+    registerRef(shape.area, Ref{ key, -1 });
+    shapes_.insert(key, std::move(shape));
+}
+
+void SpatialGrid::remove(quint64 key)
+{
+    auto it = shapes_.find(key);
+    if (it == shapes_.end()) {
+        return;
+    }
+
+    auto dropFrom = [this, key](const QRectF& bounds) {
+        const QRect cr = cellRange(bounds);
+        for (int cy = cr.top(); cy <= cr.bottom(); ++cy) {
+            for (int cx = cr.left(); cx <= cr.right(); ++cx) {
+                auto cell = cells_.find(cellKey(cx, cy));
+                if (cell == cells_.end()) continue;
+                QVector<Ref>& refs = cell.value();
+                refs.erase(std::remove_if(refs.begin(), refs.end(),
+                    [key](const Ref& r) { return r.key == key; }), refs.end());
+                if (refs.isEmpty()) {
+                    cells_.erase(cell);
+                }
+            }
+        }
+        };
+
+    const Shape& shape = it.value();
+    if (shape.isArea) {
+        dropFrom(shape.area);
+    }
+    else {
+        for (const QLineF& s : shape.segments) {
+            dropFrom(SegmentBounds(s, shape.halfWidth));
+        }
+    }
+    shapes_.erase(it);
+}
+
+QSet<quint64> SpatialGrid::query(const QVector<QPoint>& path, qreal radius) const
+{
+    QSet<quint64> hits;
+    if (path.isEmpty() || shapes_.isEmpty()) {
+        return hits;
+    }
+
+    QVector<QLineF> eraser;
+    if (path.size() == 1) {
+        eraser.push_back(QLineF(path[0], path[0]));
+    }
+    for (int i = 1; i < path.size(); ++i) {
+        eraser.push_back(QLineF(path[i - 1], path[i]));
+    }
+
+    for (const QLineF& e : eraser) {
+        const QRect cr = cellRange(SegmentBounds(e, radius));
+        for (int cy = cr.top(); cy <= cr.bottom(); ++cy) {
+            for (int cx = cr.left(); cx <= cr.right(); ++cx) {
+                auto cell = cells_.constFind(cellKey(cx, cy));
+                if (cell == cells_.constEnd()) continue;
+
+                for (const Ref& ref : cell.value()) {
+                    if (hits.contains(ref.key)) continue;
+                    const Shape& shape = *shapes_.constFind(ref.key);
+                    const bool hit = shape.isArea
+                        ? SegmentRectDistance(e, shape.area) <= radius
+                        : SegmentDistance(e, shape.segments[ref.segment]) <= radius + shape.halfWidth;
+                    if (hit) {
+                        hits.insert(ref.key);
+                    }
+                }
+            }
+        }
+    }
+    return hits;
+}
+
+qreal SpatialGrid::SegmentDistance(const QLineF& a, const QLineF& b)
+{
+    if (a.length() > 0 && b.length() > 0 &&
+        a.intersects(b, nullptr) == QLineF::BoundedIntersection) {
+        return 0;
+    }
+    return std::min({ PointSegmentDistance(a.p1(), b), PointSegmentDistance(a.p2(), b),
+                      PointSegmentDistance(b.p1(), a), PointSegmentDistance(b.p2(), a) });
+}
+
+qreal SpatialGrid::SegmentRectDistance(const QLineF& s, const QRectF& rect)
+{
+    if (rect.contains(s.p1()) || rect.contains(s.p2())) {
+        return 0;
+    }
+    const QLineF edges[] = {
+        QLineF(rect.topLeft(), rect.topRight()),
+        QLineF(rect.topRight(), rect.bottomRight()),
+        QLineF(rect.bottomRight(), rect.bottomLeft()),
+        QLineF(rect.bottomLeft(), rect.topLeft()),
+    };
+    qreal best = SegmentDistance(s, edges[0]);
+    for (int i = 1; i < 4; ++i) {
+        best = std::min(best, SegmentDistance(s, edges[i]));
+    }
+    return best;
+}
@@ -0,0 +1,195 @@
+#include "StreamingPngWriter.h"
+
+#include <QtEndian>
+#include <zlib.h>
+
+namespace {
+
+    constexpr int kIdatChunkSize = 64 * 1024;
+    constexpr int kCompressionLevel = 3;       // 长图以速度优先，屏幕内容在低级别下也压得很好
+    constexpr qint64 kMaxPngDimension = 0x7FFFFFFF;
+
+    QByteArray BigEndian32(quint32 v)
+    {
+        QByteArray out(4, Qt::Uninitialized);
+        qToBigEndian(v, out.data());
+        return out;
+    }
+
+} // namespace
+
+struct StreamingPngWriter::Deflater
+{
+    z_stream zs{};
+};
+
+StreamingPngWriter::StreamingPngWriter() = default;
+
+StreamingPngWriter::~StreamingPngWriter()
+{
+    if (deflater_) {
+        deflateEnd(&deflater_->zs);
+    }
+    if (file_.isOpen()) {
+        // 没有正常 close 的文件是不完整的
+        file_.close();
+        file_.remove();
+    }
+}
+
+bool StreamingPngWriter::fail(const QString& message)
+{
+    error_ = message;
+    return false;
+}
+
+bool StreamingPngWriter::open(const QString& path, int width, qint64 height)
+{
+    if (width <= 0 || height <= 0 || width > kMaxPngDimension || height > kMaxPngDimension) {
+        return fail(QStringLiteral("invalid PNG size %1x%2").arg(width).arg(height));
+    }
+
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return fail(file_.errorString());
+    }
+
+    deflater_ = std::make_unique<Deflater>();
+    if (deflateInit(&deflater_->zs, kCompressionLevel) != Z_OK) {
+        deflater_.reset();
+        return fail(QStringLiteral("deflateInit failed"));
+    }
+
+    width_ = width;
+    height_ = height;
+    rowsWritten_ = 0;
+    rowBuffer_.resize(1 + qsizetype(width) * 3);
+
+    static const char kSignature[8] = { char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (file_.write(kSignature, 8) != 8) {
+        return fail(file_.errorString());
+    }
+
+    QByteArray ihdr;
+    ihdr += BigEndian32(quint32(width));
+    ihdr += BigEndian32(quint32(height));
+    ihdr += char(8);   // 位深
+    ihdr += char(2);   // 颜色类型：RGB
+    ihdr += char(0);   // 压缩方式
+    ihdr += char(0);   // 过滤方式
+    ihdr += char(0);   // 不隔行
+    return writeChunk("IHDR", ihdr);
+}
+
+bool StreamingPngWriter::writeRows(const QImage& rows)
+{
+    if (!deflater_) {
+        return fail(QStringLiteral("writer is not open"));
+    }
+    if (rows.isNull()) {
+        return true;
+    }
+    if (rows.width() != width_) {
+        return fail(QStringLiteral("row width %1 does not match %2").arg(rows.width()).arg(width_));
+    }
+    if (rowsWritten_ + rows.height() > height_) {
+        return fail(QStringLiteral("too many rows"));
+    }
+
+    const QImage rgb = rows.format() == QImage::Format_RGB888
+        ? rows : rows.convertToFormat(QImage::Format_RGB888);
+
+    uchar* out = reinterpret_cast<uchar*>(rowBuffer_.data());
+    const int bytes = width_ * 3;
+    for (int y = 0; y < rgb.height(); ++y) {
+        const uchar* in = rgb.constScanLine(y);
+        // Sub 过滤：每个字节减去左边像素的同一通道
+        out[0] = 1;
+        for (int i = 0; i < 3 && i < bytes; ++i) {
+            out[1 + i] = in[i];
+        }
+        for (int i = 3; i < bytes; ++i) {
+            out[1 + i] = uchar(in[i] - in[i - 3]);
+        }
+        if (!deflateInput(out, size_t(rowBuffer_.size()), false)) {
+            return false;
+        }
+    }
+    rowsWritten_ += rgb.height();
+    return true;
+}
+
+bool StreamingPngWriter::deflateInput(const uchar* data, size_t size, bool finish)
+{
+    z_stream& zs = deflater_->zs;
+    zs.next_in = const_cast<Bytef*>(data);
+    zs.avail_in = uInt(size);
+
+    uchar buffer[16 * 1024];
+    int ret = Z_OK;
+    do {
+        zs.next_out = buffer;
+        zs.avail_out = sizeof(buffer);
+        ret = deflate(&zs, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (ret == Z_STREAM_ERROR) {
+            return fail(QStringLiteral("deflate failed"));
+        }
+        pending_.append(reinterpret_cast<const char*>(buffer), int(sizeof(buffer) - zs.avail_out));
+        if (!flushIdat(false)) {
+            return false;
+        }
+    } while (zs.avail_out == 0 || (finish && ret != Z_STREAM_END));
+    return true;
+}
+
+bool StreamingPngWriter::flushIdat(bool all)
+{
+    while (pending_.size() >= kIdatChunkSize || (all && !pending_.isEmpty())) {
+        const qsizetype n = qMin<qsizetype>(pending_.size(), kIdatChunkSize);
+        if (!writeChunk("IDAT", pending_.left(n))) {
+            return false;
+        }
+        pending_.remove(0, n);
+    }
+    return true;
+}
+
+bool StreamingPngWriter::writeChunk(const char* type, const QByteArray& data)
+{
+    quint32 crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(type), 4);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), uInt(data.size()));
+
+    if (file_.write(BigEndian32(quint32(data.size()))) != 4 ||
+        file_.write(type, 4) != 4 ||
+        file_.write(data) != data.size() ||
+        file_.write(BigEndian32(crc)) != 4) {
+        return fail(file_.errorString());
+    }
+    return true;
+}
+
+bool StreamingPngWriter::close()
+{
+    if (!deflater_) {
+        return fail(QStringLiteral("writer is not open"));
+    }
+
+    bool ok = true;
+    if (rowsWritten_ != height_) {
+        ok = fail(QStringLiteral("expected %1 rows, got %2").arg(height_).arg(rowsWritten_));
+    }
+    ok = ok && deflateInput(nullptr, 0, true);
+    ok = ok && flushIdat(true);
+    ok = ok && writeChunk("IEND", QByteArray());
+
+    deflateEnd(&deflater_->zs);
+    deflater_.reset();
+    pending_.clear();
+
+    file_.close();
+    if (!ok) {
+        file_.remove();
+    }
+    return ok;
+}
@@ -0,0 +1,197 @@
+#include "TiledCanvas.h"
+
+#include <QPainter>
+
+void TiledCanvas::reset(const QPixmap& pixmap)
+{
+    clear();
+    if (pixmap.isNull()) {
+        return;
+    }
+
+    size_ = pixmap.size();
+    cols_ = (size_.width() + kTileSize - 1) / kTileSize;
+    rows_ = (size_.height() + kTileSize - 1) / kTileSize;
+
+    tiles_.reserve(cols_ * rows_);
+    for (int row = 0; row < rows_; ++row) {
+        for (int col = 0; col < cols_; ++col) {
+            QPixmap tile = pixmap.copy(tileRect(col, row));
+            tile.setDevicePixelRatio(1.0);
+            tiles_.push_back(tile);
+        }
+    }
+    dirty_.fill(false, tiles_.size());
+}
+
+void TiledCanvas::clear()
+{
+    size_ = QSize();
+    cols_ = 0;
+    rows_ = 0;
+    tiles_.clear();
+    dirty_.clear();
+    dirty_count_ = 0;
+}
+
+QRect TiledCanvas::tileRect(int col, int row) const
+{
+    return QRect(col * kTileSize, row * kTileSize, kTileSize, kTileSize).intersected(rect());
+}
+
+void TiledCanvas::markDirty(const QRect& area)
+{
+    const QRect r = area.intersected(rect());
+    if (r.isEmpty()) {
+        return;
+    }
+
+    const int c0 = r.left() / kTileSize;
+    const int c1 = r.right() / kTileSize;
+    const int r0 = r.top() / kTileSize;
+    const int r1 = r.bottom() / kTileSize;
+    for (int row = r0; row <= r1; ++row) {
+        for (int col = c0; col <= c1; ++col) {
+            bool& d = dirty_[row * cols_ + col];
+            if (!d) {
+                d = true;
+                ++dirty_count_;
+            }
+        }
+    }
+}
+
+int TiledCanvas::recompose(const Renderer& renderer)
+{
+    if (!hasDirty()) {
+        return 0;
+    }
+
+    // 每行先找连续的脏 tile 段；和上一行列范围相同的段向下合并，
+    // 这样一个矩形对象弄脏的 tile 通常只触发一次 renderer
+    struct Span { int c0, c1, r0, r1; };
+    QVector<Span> spans;
+    QVector<Span> open;  // 上一行结束时仍可向下延伸的段
+
+    for (int row = 0; row < rows_; ++row) {
+        QVector<Span> next;
+        int col = 0;
+        while (col < cols_) {
+            if (!dirty_[row * cols_ + col]) {
+                ++col;
+                continue;
+            }
+            int end = col;
+            while (end + 1 < cols_ && dirty_[row * cols_ + end + 1]) {
+                ++end;
+            }
+
+            Span s{ col, end, row, row };
+            for (int i = 0; i < open.size(); ++i) {
+                if (open[i].c0 == col && open[i].c1 == end) {
+                    s.r0 = open[i].r0;
+                    open.remove(i);
+                    break;
+                }
+            }
+            next.push_back(s);
+            col = end + 1;
+        }
+        spans += open;   // 没能延续的段就此结束
+        open = next;
+    }
+    spans += open;
+
+    int count = 0;
+    for (const Span& s : spans) {
+        const QRect area = tileRect(s.c0, s.r0).united(tileRect(s.c1, s.r1));
+        QPixmap patch(area.size());
+        patch.fill(Qt::transparent);
+        renderer(patch, area);
+        write(patch, area);
+        count += (s.c1 - s.c0 + 1) * (s.r1 - s.r0 + 1);
+    }
+
+    dirty_.fill(false);
+    dirty_count_ = 0;
+    return count;
+}
+
+void TiledCanvas::modify(const QRect& area, const Renderer& fn)
+{
+    const QRect r = area.intersected(rect());
+    if (r.isEmpty()) {
+        return;
+    }
+    QPixmap patch = copy(r);
+    fn(patch, r);
+    write(patch, r);
+}
+
+QPixmap TiledCanvas::copy(const QRect& area) const
+{
+    const QRect r = area.intersected(rect());
+    if (r.isEmpty()) {
+        return QPixmap();
+    }
+
+    QPixmap out(r.size());
+    out.fill(Qt::transparent);
+
+    QPainter p(&out);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    for (int row = r.top() / kTileSize; row <= r.bottom() / kTileSize; ++row) {
+        for (int col = r.left() / kTileSize; col <= r.right() / kTileSize; ++col) {
+            const QRect tr = tileRect(col, row);
+            const QRect part = tr.intersected(r);
+            p.drawPixmap(part.translated(-r.topLeft()), tiles_[row * cols_ + col],
+                part.translated(-tr.topLeft()));
+        }
+    }
+    p.end();
+    return out;
+}
+
+void TiledCanvas::write(const QPixmap& patch, const QRect& area)
+{
+    const QRect r = area.intersected(rect());
+    for (int row = r.top() / kTileSize; row <= r.bottom() / kTileSize; ++row) {
+        for (int col = r.left() / kTileSize; col <= r.right() / kTileSize; ++col) {
+            const QRect tr = tileRect(col, row);
+            const QRect part = tr.intersected(r);
+            if (part.isEmpty()) continue;
+
+            QPainter p(&tiles_[row * cols_ + col]);
+            // 擦除会产生透明像素，必须整块替换而不是叠加
+            p.setCompositionMode(QPainter::CompositionMode_Source);
+            p.drawPixmap(part.translated(-tr.topLeft()), patch, part.translated(-area.topLeft()));
+        }
+    }
+}
+
+void TiledCanvas::draw(QPainter& painter, const QRect& target, const QRect& src, const QRect& exposed) const
+{
+    const QRect s = src.intersected(rect());
+    if (s.isEmpty() || target.isEmpty()) {
+        return;
+    }
+
+    const double sx = double(target.width()) / src.width();
+    const double sy = double(target.height()) / src.height();
+
+    for (int row = s.top() / kTileSize; row <= s.bottom() / kTileSize; ++row) {
+        for (int col = s.left() / kTileSize; col <= s.right() / kTileSize; ++col) {
+            const QRect tr = tileRect(col, row);
+            const QRect part = tr.intersected(s);
+
+            const QRectF dst(target.x() + (part.x() - src.x()) * sx,
+                target.y() + (part.y() - src.y()) * sy,
+                part.width() * sx,
+                part.height() * sy);
+            if (!exposed.intersects(dst.toAlignedRect())) {
+                continue;
+            }
+            painter.drawPixmap(dst, tiles_[row * cols_ + col], QRectF(part.translated(-tr.topLeft())));
+        }
+    }
+}
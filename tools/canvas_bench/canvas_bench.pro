@@ -0,0 +1,18 @@
+# 编辑画布基准：只依赖 QtCore / QtGui，可在 Linux 下用 offscreen 平台运行
+TEMPLATE = app
+TARGET = canvas_bench
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SRC_DIR = $$PWD/../../src
+
+INCLUDEPATH += "$$SRC_DIR/Head Files" $$PWD/../common
+
+HEADERS += \
+    $$PWD/../common/bench_util.h \
+    "$$SRC_DIR/Head Files/TiledCanvas.h"
+
+SOURCES += \
+    main.cpp \
+    "$$SRC_DIR/Resources files/TiledCanvas.cpp"
@@ -0,0 +1,245 @@
+// 编辑画布基准：在一张大画布上依次提交 N 个标注，再随机擦掉一部分，
+// 对比分块画布（TiledCanvas 追加 / 脏 tile 重建）和整张重放（从底图 + 全部标注重画）的耗时，
+// 并检查两种方式得到的像素是否一致。只用到 QPixmap / QPainter，可在 offscreen 平台下运行：
+//   QT_QPA_PLATFORM=offscreen ./canvas_bench --size 3840x2160 --items 300
+#include "TiledCanvas.h"
+#include "bench_util.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <QPolygon>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+    // 与编辑器里的矩形 / 椭圆 / 画笔三类矢量标注对应
+    struct BenchItem {
+        enum class Kind { kRect, kEllipse, kPen };
+        Kind kind = Kind::kRect;
+        QRect rect;
+        QPolygon path;
+        QColor color;
+        int width = 3;
+
+        QRect bounds() const
+        {
+            const QRect r = kind == Kind::kPen ? path.boundingRect() : rect;
+            const int pad = width / 2 + 2;
+            return r.adjusted(-pad, -pad, pad, pad);
+        }
+    };
+
+    QVector<BenchItem> MakeItems(int count, const QSize& canvas, quint32 seed)
+    {
+        QRandomGenerator rng(seed);
+        QVector<BenchItem> items;
+        items.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            BenchItem item;
+            item.kind = static_cast<BenchItem::Kind>(rng.bounded(3));
+            item.color = QColor::fromHsv(rng.bounded(360), 200, 230);
+            item.width = rng.bounded(2, 9);
+            const int w = rng.bounded(40, qMax(41, qMin(600, canvas.width() / 2)));
+            const int h = rng.bounded(40, qMax(41, qMin(600, canvas.height() / 2)));
+            const QPoint origin(rng.bounded(qMax(1, canvas.width() - w)), rng.bounded(qMax(1, canvas.height() - h)));
+            item.rect = QRect(origin, QSize(w, h));
+            if (item.kind == BenchItem::Kind::kPen) {
+                // 手绘路径：在外接矩形里随机游走
+                QPoint p = item.rect.center();
+                const int points = rng.bounded(20, 80);
+                for (int k = 0; k < points; ++k) {
+                    p += QPoint(rng.bounded(-24, 25), rng.bounded(-24, 25));
+                    p.setX(qBound(item.rect.left(), p.x(), item.rect.right()));
+                    p.setY(qBound(item.rect.top(), p.y(), item.rect.bottom()));
+                    item.path << p;
+                }
+            }
+            items.push_back(item);
+        }
+        return items;
+    }
+
+    // 底图：渐变 + 网格，避免纯色底图让 drawPixmap 走特殊路径
+    QPixmap MakeBase(const QSize& size)
+    {
+        QImage image(size, QImage::Format_ARGB32_Premultiplied);
+        for (int y = 0; y < size.height(); ++y) {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < size.width(); ++x) {
+                const bool grid = (x % 64) == 0 || (y % 64) == 0;
+                line[x] = grid ? qRgb(200, 200, 210) : qRgb((x >> 4) & 0xFF, (y >> 4) & 0xFF, 180);
+            }
+        }
+        return QPixmap::fromImage(image);
+    }
+
+    // offset：item 坐标到 painter 坐标的平移（分块时是 -patch 左上角）
+    void DrawItem(QPainter& p, const BenchItem& item, const QPoint& offset)
+    {
+        p.save();
+        p.translate(offset);
+        p.setRenderHint(QPainter::Antialiasing, true);
+        p.setPen(QPen(item.color, item.width, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        p.setBrush(Qt::NoBrush);
+        switch (item.kind) {
+        case BenchItem::Kind::kRect: p.drawRect(item.rect); break;
+        case BenchItem::Kind::kEllipse: p.drawEllipse(item.rect); break;
+        case BenchItem::Kind::kPen: p.drawPolyline(item.path); break;
+        }
+        p.restore();
+    }
+
+    // 旧做法：每次提交都从底图 + 全部 items 重画整张画布
+    QPixmap FullReplay(const QPixmap& base, const QVector<BenchItem>& items, const std::vector<bool>& alive, int upTo)
+    {
+        QPixmap canvas = base.copy();
+        QPainter p(&canvas);
+        for (int i = 0; i < upTo; ++i) {
+            if (alive[i]) {
+                DrawItem(p, items[i], QPoint());
+            }
+        }
+        p.end();
+        return canvas;
+    }
+
+    struct Timing {
+        QString op;
+        std::vector<qint64> us;
+        qint64 pixels = 0;   // 实际重画的像素数之和
+    };
+
+    void PrintHeader(QTextStream& out)
+    {
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+            .arg(QStringLiteral("op"), -14).arg(QStringLiteral("count"), 6).arg(QStringLiteral("avg-us"), 9)
+            .arg(QStringLiteral("p95-us"), 9).arg(QStringLiteral("max-us"), 9).arg(QStringLiteral("mpixels"), 9);
+    }
+
+    void PrintTiming(QTextStream& out, Timing t)
+    {
+        if (t.us.empty()) {
+            return;
+        }
+        std::sort(t.us.begin(), t.us.end());
+        qint64 sum = 0;
+        for (qint64 v : t.us) sum += v;
+        const size_t p95 = std::min(t.us.size() - 1, t.us.size() * 95 / 100);
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+            .arg(t.op, -14).arg(qint64(t.us.size()), 6).arg(sum / qint64(t.us.size()), 9)
+            .arg(t.us[p95], 9).arg(t.us.back(), 9).arg(t.pixels / 1e6, 9, 'f', 1);
+    }
+
+    bool SamePixels(const QPixmap& a, const QPixmap& b)
+    {
+        return a.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied)
+            == b.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchUtil::UseOffscreenByDefault();
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Commits N annotations to a large edit canvas and compares tiled "
+        "append / dirty-tile recompose against replaying every item on the whole canvas.");
+    parser.addHelpOption();
+    QCommandLineOption sizeOpt("size", "Canvas size.", "WxH", "3840x2160");
+    QCommandLineOption itemsOpt("items", "Number of annotations to commit.", "n", "300");
+    QCommandLineOption eraseOpt("erase", "Number of annotations to erase afterwards.", "n", "50");
+    QCommandLineOption seedOpt("seed", "Random seed.", "n", "1");
+    QCommandLineOption noReplayOpt("no-replay", "Skip the whole-canvas replay baseline (quadratic in --items).");
+    parser.addOptions({ sizeOpt, itemsOpt, eraseOpt, seedOpt, noReplayOpt });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QSize size = BenchUtil::ParseSize(parser.value(sizeOpt));
+    const int count = parser.value(itemsOpt).toInt();
+    const int eraseCount = qBound(0, parser.value(eraseOpt).toInt(), count);
+    if (size.width() < 64 || size.height() < 64 || count <= 0) {
+        err << "invalid --size or --items\n";
+        return BenchUtil::kExitUsage;
+    }
+    const bool replay = !parser.isSet(noReplayOpt);
+
+    const QPixmap base = MakeBase(size);
+    const QVector<BenchItem> items = MakeItems(count, size, parser.value(seedOpt).toUInt());
+    std::vector<bool> alive(items.size(), true);
+
+    TiledCanvas canvas;
+    canvas.reset(base);
+
+    Timing append{ QStringLiteral("tiled-append") };
+    Timing full{ QStringLiteral("full-replay") };
+    QElapsedTimer timer;
+    for (int i = 0; i < items.size(); ++i) {
+        const BenchItem& item = items[i];
+        const QRect area = item.bounds().intersected(canvas.rect());
+        timer.start();
+        canvas.modify(area, [&item](QPixmap& patch, const QRect& r) {
+            QPainter p(&patch);
+            DrawItem(p, item, -r.topLeft());
+            });
+        append.us.push_back(timer.nsecsElapsed() / 1000);
+        append.pixels += qint64(area.width()) * area.height();
+
+        if (replay) {
+            timer.start();
+            const QPixmap whole = FullReplay(base, items, alive, i + 1);
+            full.us.push_back(timer.nsecsElapsed() / 1000);
+            full.pixels += qint64(size.width()) * size.height();
+            Q_UNUSED(whole);
+        }
+    }
+    const bool appendMatches = SamePixels(canvas.toPixmap(), FullReplay(base, items, alive, items.size()));
+
+    // 擦除：对象从列表里去掉后，只重建它覆盖到的 tile（底图 + 与之相交的剩余对象）
+    Timing erase{ QStringLiteral("tiled-erase") };
+    QRandomGenerator rng(parser.value(seedOpt).toUInt() ^ 0xC0FFEEu);
+    for (int n = 0; n < eraseCount; ++n) {
+        int victim = rng.bounded(items.size());
+        while (!alive[victim]) {
+            victim = (victim + 1) % items.size();
+        }
+        alive[victim] = false;
+
+        timer.start();
+        canvas.markDirty(items[victim].bounds());
+        qint64 pixels = 0;
+        canvas.recompose([&](QPixmap& patch, const QRect& area) {
+            QPainter p(&patch);
+            p.drawPixmap(QPoint(0, 0), base, area);
+            for (int i = 0; i < items.size(); ++i) {
+                if (alive[i] && items[i].bounds().intersects(area)) {
+                    DrawItem(p, items[i], -area.topLeft());
+                }
+            }
+            pixels += qint64(area.width()) * area.height();
+            });
+        erase.us.push_back(timer.nsecsElapsed() / 1000);
+        erase.pixels += pixels;
+    }
+    const bool eraseMatches = SamePixels(canvas.toPixmap(), FullReplay(base, items, alive, items.size()));
+
+    out << "canvas " << size.width() << 'x' << size.height() << ", " << count << " items, "
+        << eraseCount << " erased, tile " << TiledCanvas::kTileSize << " px\n";
+    PrintHeader(out);
+    PrintTiming(out, append);
+    PrintTiming(out, erase);
+    PrintTiming(out, full);
+    return BenchUtil::ReportMatch(out, QString("pixels match full replay (append %1, erase %2)")
+        .arg(appendMatches ? QStringLiteral("yes") : QStringLiteral("NO"),
+            eraseMatches ? QStringLiteral("yes") : QStringLiteral("NO")), appendMatches && eraseMatches);
+}
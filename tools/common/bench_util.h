@@ -0,0 +1,84 @@
+#pragma once
+
+// tools/ 下各基准 / 检查程序共用的小工具：offscreen 启动、命令行列表解析、
+// 中位数计时和“是否与参考一致”的结论行。只有头文件，各 .pro 把 ../common 加进 INCLUDEPATH
+#include <QElapsedTimer>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <vector>
+
+namespace BenchUtil {
+
+    // 退出码：1 = 参数错误，2 = 结果与参考不一致
+    constexpr int kExitUsage = 1;
+    constexpr int kExitMismatch = 2;
+
+    // 在创建 QGuiApplication 之前调用；已经设置了 QT_QPA_PLATFORM 时不覆盖
+    inline void UseOffscreenByDefault()
+    {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+    // "5,10,20" -> {5, 10, 20}
+    inline QVector<int> ParseInts(const QString& text)
+    {
+        QVector<int> values;
+        for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+            values << part.trimmed().toInt();
+        }
+        return values;
+    }
+
+    // "1920x1080" -> QSize(1920, 1080)；格式不对时得到空尺寸
+    inline QSize ParseSize(const QString& text)
+    {
+        const QStringList wh = text.trimmed().split('x');
+        return QSize(wh.value(0).toInt(), wh.value(1).toInt());
+    }
+
+    // "640x480,3840x2160" -> 尺寸列表
+    inline QVector<QSize> ParseSizes(const QString& text)
+    {
+        QVector<QSize> sizes;
+        for (const QString& part : text.split(',', Qt::SkipEmptyParts)) {
+            sizes << ParseSize(part);
+        }
+        return sizes;
+    }
+
+    // 多跑几次取中位数，减少抖动；每次计时前先执行 prepare（不计时），例如恢复原图
+    template <typename Prepare, typename Fn>
+    qint64 MedianUs(int runs, Prepare prepare, Fn fn)
+    {
+        std::vector<qint64> samples;
+        QElapsedTimer timer;
+        for (int i = 0; i < qMax(1, runs); ++i) {
+            prepare();
+            timer.start();
+            fn();
+            samples.push_back(timer.nsecsElapsed() / 1000);
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    template <typename Fn>
+    qint64 MedianUs(int runs, Fn fn)
+    {
+        return MedianUs(runs, [] {}, fn);
+    }
+
+    // 输出 "<what>: yes / NO" 结论行，返回 main 的退出码
+    inline int ReportMatch(QTextStream& out, const QString& what, bool ok)
+    {
+        out << what << ": " << (ok ? "yes" : "NO") << '\n';
+        return ok ? 0 : kExitMismatch;
+    }
+
+} // namespace BenchUtil
@@ -0,0 +1,33 @@
+# 长截图离线回放工具：只依赖 QtCore / QtGui，可在 Linux 下用 offscreen 平台运行
+TEMPLATE = app
+TARGET = longshot_replay
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SRC_DIR = $$PWD/../../src
+
+INCLUDEPATH += "$$SRC_DIR/Head Files"
+
+HEADERS += \
+    "$$SRC_DIR/Head Files/PanoramaCanvas.h" \
+    "$$SRC_DIR/Head Files/ScrollStitcher.h" \
+    "$$SRC_DIR/Head Files/SegmentStore.h" \
+    "$$SRC_DIR/Head Files/StreamingPngWriter.h"
+
+SOURCES += \
+    main.cpp \
+    "$$SRC_DIR/Resources files/PanoramaCanvas.cpp" \
+    "$$SRC_DIR/Resources files/ScrollStitcher.cpp" \
+    "$$SRC_DIR/Resources files/SegmentStore.cpp" \
+    "$$SRC_DIR/Resources files/StreamingPngWriter.cpp"
+
+# StreamingPngWriter 直接调用 zlib：Windows 下用和主工程相同的 3rdparty/cpp/zlib，其它平台用系统 zlib
+win32 {
+    INCLUDEPATH += $$PWD/../../3rdparty/cpp/zlib/include
+    LIBS += -L$$PWD/../../3rdparty/cpp/zlib/lib
+    CONFIG(debug, debug|release): LIBS += -lzlibstaticd
+    else: LIBS += -lzlibstatic
+} else {
+    LIBS += -lz
+}
@@ -0,0 +1,867 @@
+// 长截图离线回放：不需要 Windows 和手动滚动，直接用 ScrollStitcher 回放一组帧，
+// 统计滚动量估计的准确率、拼接结果的逐行正确率、处理帧率和峰值内存。
+// 帧来源可以是内置的合成场景（已知滚动量，可加噪声 / 吸顶吸底 / 动画区域；
+// 也有在二维文档上横向 / 斜向平移的全景场景），也可以是录制好的 PNG 序列。
+// 只用到 QImage，可在 offscreen 平台下无界面运行：
+//   QT_QPA_PLATFORM=offscreen ./longshot_replay --scenario all --band
+#include "PanoramaCanvas.h"
+#include "ScrollStitcher.h"
+#include "SegmentStore.h"
+#include "StreamingPngWriter.h"
+
+#include <QColor>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+    // ---------------- 帧来源 ----------------
+
+    class FrameSource
+    {
+    public:
+        virtual ~FrameSource() = default;
+        virtual QString name() const = 0;
+        virtual int count() const = 0;
+        virtual QImage frame(int index) const = 0;
+        // 第 index 帧的滚动位置（内容顶部对应文档的第几行），未知时为 -1
+        virtual qint64 position(int index) const { Q_UNUSED(index); return -1; }
+        // 吸顶 / 吸底的真实行数，用来判断一次滚动是否还有重叠
+        virtual int headerRows() const { return 0; }
+        virtual int footerRows() const { return 0; }
+        // 理想拼接结果（所有帧都被正确拼接时的输出），未知时为空
+        virtual QImage expected() const { return QImage(); }
+    };
+
+    struct ScenarioSpec {
+        const char* name;
+        int minStep;
+        int maxStep;
+        double pauseChance;   // 停顿（滚动量 0）的概率
+        double jumpChance;    // 一次滚过超过一屏（必然漏拍）的概率
+        int header;
+        int footer;
+        int noisePixels;      // 每帧在滚动区随机扰动的像素数（光标闪烁等）
+        bool animated;        // 滚动区里固定位置有一块一直在变的区域（动图 / 加载动画）
+    };
+
+    const ScenarioSpec kScenarios[] = {
+        { "steady",   120, 120, 0.00, 0.00,  0,  0, 0, false },
+        { "variable",  10, 400, 0.20, 0.00,  0,  0, 0, false },
+        { "noise",     40, 300, 0.15, 0.00,  0,  0, 6, false },
+        { "sticky",    40, 300, 0.15, 0.00, 64, 48, 0, false },
+        { "animated",  40, 300, 0.15, 0.00,  0,  0, 0, true  },
+        { "jumps",     40, 300, 0.10, 0.08,  0,  0, 0, false },
+    };
+
+    // 5x9 的随机点阵当作一个“字”，画在 8x12 的格子里；每行像素都不一样，接近真实文字
+    void DrawGlyph(QImage& image, int x, int y, quint64 bits, QRgb ink)
+    {
+        for (int gy = 0; gy < 9; ++gy) {
+            if (y + gy < 0 || y + gy >= image.height()) continue;
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y + gy));
+            for (int gx = 0; gx < 5; ++gx) {
+                if (x + gx >= image.width()) break;
+                if (bits & (1ull << (gy * 5 + gx))) {
+                    line[x + gx] = ink;
+                }
+            }
+        }
+    }
+
+    // 一行“文字”：若干个词，词之间空一格
+    void DrawTextLine(QImage& image, int y, QRandomGenerator& rng, QRgb ink)
+    {
+        int x = 24 + rng.bounded(3) * 16;
+        const int right = image.width() - 40 - rng.bounded(qMax(1, image.width() / 4));
+        while (x < right) {
+            const int letters = rng.bounded(2, 9);
+            for (int i = 0; i < letters && x < right; ++i) {
+                DrawGlyph(image, x, y, rng.generate64(), ink);
+                x += 8;
+            }
+            x += 8;
+        }
+    }
+
+    // 合成文档：文字行、段落间空白（纯色行）和渐变色块（图片）交替
+    QImage MakePage(int width, int height, quint32 seed)
+    {
+        QImage page(width, height, QImage::Format_RGB32);
+        page.fill(Qt::white);
+        QRandomGenerator rng(seed);
+
+        int y = 16;
+        while (y < height - 16) {
+            const int kind = rng.bounded(10);
+            if (kind < 7) {
+                DrawTextLine(page, y, rng, qRgb(30 + rng.bounded(40), 30 + rng.bounded(40), 40));
+                y += 18;
+            }
+            else if (kind == 7) {
+                y += rng.bounded(12, 40);
+            }
+            else {
+                const int bh = qMin(rng.bounded(60, 220), height - 16 - y);
+                const int bx = 24 + rng.bounded(width / 8);
+                const int bw = width - 24 - bx - rng.bounded(width / 3);
+                const int tint = rng.bounded(256);
+                for (int by = 0; by < bh; ++by) {
+                    QRgb* line = reinterpret_cast<QRgb*>(page.scanLine(y + by));
+                    for (int bxi = 0; bxi < bw; ++bxi) {
+                        line[bx + bxi] = qRgb((bxi + by * 3 + tint) & 0xFF,
+                            (bxi * 2 + tint) & 0xFF,
+                            (by * 5 + bxi) & 0xFF);
+                    }
+                }
+                y += bh + 12;
+            }
+        }
+        return page;
+    }
+
+    // 吸顶 / 吸底栏：底色 + 一行字，靠内容一侧有一条分隔线（dividerAtTop 为吸底栏）
+    QImage MakeBar(int width, int height, quint32 seed, QRgb background, bool dividerAtTop)
+    {
+        QImage bar(width, height, QImage::Format_RGB32);
+        bar.fill(background);
+        if (height >= 12) {
+            QRandomGenerator rng(seed);
+            DrawTextLine(bar, (height - 9) / 2, rng, qRgb(20, 20, 60));
+        }
+        QRgb* divider = reinterpret_cast<QRgb*>(bar.scanLine(dividerAtTop ? 0 : height - 1));
+        for (int x = 0; x < width; x += 2) {
+            divider[x] = qRgb(160, 160, 170);
+        }
+        return bar;
+    }
+
+    void CopyRows(QImage& dst, int dstY, const QImage& src, int srcY, int rows)
+    {
+        const size_t bytes = size_t(qMin(dst.bytesPerLine(), src.bytesPerLine()));
+        for (int i = 0; i < rows; ++i) {
+            memcpy(dst.scanLine(dstY + i), src.constScanLine(srcY + i), bytes);
+        }
+    }
+
+    class SyntheticSource : public FrameSource
+    {
+    public:
+        SyntheticSource(const ScenarioSpec& spec, const QSize& viewport, int pageHeight, quint32 seed)
+            : spec_(spec), viewport_(viewport), seed_(seed)
+        {
+            page_ = MakePage(viewport.width(), pageHeight, seed);
+            if (spec.header > 0) header_ = MakeBar(viewport.width(), spec.header, seed + 1, qRgb(225, 235, 250), false);
+            if (spec.footer > 0) footer_ = MakeBar(viewport.width(), spec.footer, seed + 2, qRgb(240, 240, 225), true);
+
+            // 生成滚动轨迹：第一帧在顶部，最后停几帧让流水线收尾
+            QRandomGenerator rng(seed ^ 0x5A5A5A5Au);
+            const qint64 maxPos = pageHeight - regionRows();
+            qint64 pos = 0;
+            positions_.push_back(pos);
+            while (pos < maxPos) {
+                const double r = rng.generateDouble();
+                int step;
+                if (r < spec.pauseChance) {
+                    step = 0;
+                }
+                else if (r < spec.pauseChance + spec.jumpChance) {
+                    step = regionRows() + rng.bounded(qMax(1, regionRows() / 2));
+                }
+                else {
+                    step = spec.minStep == spec.maxStep ? spec.minStep : rng.bounded(spec.minStep, spec.maxStep + 1);
+                }
+                pos = qMin(maxPos, pos + step);
+                positions_.push_back(pos);
+            }
+            for (int i = 0; i < 3; ++i) {
+                positions_.push_back(pos);
+            }
+        }
+
+        QString name() const override { return QString::fromLatin1(spec_.name); }
+        int count() const override { return positions_.size(); }
+        qint64 position(int index) const override { return positions_[index]; }
+        int headerRows() const override { return spec_.header; }
+        int footerRows() const override { return spec_.footer; }
+
+        QImage frame(int index) const override
+        {
+            const int w = viewport_.width();
+            const int h = viewport_.height();
+            const int region = regionRows();
+            QImage out(w, h, QImage::Format_RGB32);
+            if (!header_.isNull()) CopyRows(out, 0, header_, 0, spec_.header);
+            CopyRows(out, spec_.header, page_, int(positions_[index]), region);
+            if (!footer_.isNull()) CopyRows(out, h - spec_.footer, footer_, 0, spec_.footer);
+
+            if (spec_.animated) {
+                // 固定在屏幕上的小动画：颜色和亮条位置每帧都变
+                const QRect box(w - 96, spec_.header + region / 3, 56, 56);
+                const QRgb fill = QColor::fromHsv((index * 37) % 360, 160, 230).rgb();
+                const int bar = (index * 7) % box.height();
+                for (int y = box.top(); y <= box.bottom(); ++y) {
+                    QRgb* line = reinterpret_cast<QRgb*>(out.scanLine(y));
+                    const QRgb c = (y - box.top() == bar) ? qRgb(20, 20, 20) : fill;
+                    for (int x = box.left(); x <= box.right(); ++x) {
+                        line[x] = c;
+                    }
+                }
+            }
+
+            if (spec_.noisePixels > 0) {
+                // 噪声只加在滚动区，吸顶 / 吸底保持稳定，场景之间互不干扰
+                QRandomGenerator rng(seed_ ^ quint32(index * 2654435761u));
+                for (int i = 0; i < spec_.noisePixels; ++i) {
+                    const int x = rng.bounded(w);
+                    const int y = spec_.header + rng.bounded(region);
+                    QRgb* line = reinterpret_cast<QRgb*>(out.scanLine(y));
+                    line[x] ^= 0x00030303;
+                }
+            }
+            return out;
+        }
+
+        // 按顺序看过的所有内容拼起来：有重叠时接上新露出的部分，跳过一屏以上时从新位置接着拼
+        QImage expected() const override
+        {
+            const int region = regionRows();
+            QVector<QPair<qint64, qint64>> ranges;   // 文档中的 [from, to)
+            qint64 covered = positions_[0] + region;
+            ranges.push_back({ positions_[0], covered });
+            for (qint64 pos : positions_) {
+                if (pos + region <= covered) continue;
+                const qint64 from = pos <= covered ? covered : pos;
+                ranges.push_back({ from, pos + region });
+                covered = pos + region;
+            }
+
+            qint64 total = spec_.header + spec_.footer;
+            for (const auto& r : ranges) total += r.second - r.first;
+
+            QImage out(viewport_.width(), int(total), QImage::Format_RGB32);
+            int y = 0;
+            if (!header_.isNull()) {
+                CopyRows(out, 0, header_, 0, spec_.header);
+                y += spec_.header;
+            }
+            for (const auto& r : ranges) {
+                CopyRows(out, y, page_, int(r.first), int(r.second - r.first));
+                y += int(r.second - r.first);
+            }
+            if (!footer_.isNull()) CopyRows(out, y, footer_, 0, spec_.footer);
+            return out;
+        }
+
+    private:
+        int regionRows() const { return viewport_.height() - spec_.header - spec_.footer; }
+
+        ScenarioSpec spec_;
+        QSize viewport_;
+        quint32 seed_;
+        QImage page_;
+        QImage header_;
+        QImage footer_;
+        QVector<qint64> positions_;
+    };
+
+    // 录制的帧序列：目录下按文件名排序的 *.png。
+    // 可选 offsets.txt：第 k 行是第 k 帧到第 k+1 帧的滚动量（-1 表示未知）；可选 expected.png 作为理想结果
+    class RecordedSource : public FrameSource
+    {
+    public:
+        explicit RecordedSource(const QString& dir)
+            : dir_(dir)
+        {
+            const QStringList files = QDir(dir).entryList({ "*.png" }, QDir::Files, QDir::Name);
+            for (const QString& f : files) {
+                if (f != QLatin1String("expected.png")) {
+                    files_.push_back(QDir(dir).filePath(f));
+                }
+            }
+
+            positions_.fill(-1, files_.size());
+            QFile offsets(QDir(dir).filePath("offsets.txt"));
+            if (!files_.isEmpty() && offsets.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                qint64 pos = 0;
+                positions_[0] = 0;
+                for (int i = 1; i < files_.size() && !offsets.atEnd(); ++i) {
+                    bool ok = false;
+                    const qint64 step = offsets.readLine().trimmed().toLongLong(&ok);
+                    if (!ok || step < 0 || pos < 0) {
+                        pos = -1;   // 之后的位置都未知
+                    }
+                    else {
+                        pos += step;
+                    }
+                    positions_[i] = pos;
+                }
+            }
+        }
+
+        QString name() const override { return QDir(dir_).dirName(); }
+        int count() const override { return files_.size(); }
+        QImage frame(int index) const override { return QImage(files_[index]).convertToFormat(QImage::Format_RGB32); }
+        qint64 position(int index) const override { return positions_[index]; }
+        QImage expected() const override
+        {
+            const QString path = QDir(dir_).filePath("expected.png");
+            return QFile::exists(path) ? QImage(path).convertToFormat(QImage::Format_RGB32) : QImage();
+        }
+
+    private:
+        QString dir_;
+        QStringList files_;
+        QVector<qint64> positions_;
+    };
+
+    // ---------------- 统计 ----------------
+
+    qint64 PeakRssKb()
+    {
+#ifdef Q_OS_LINUX
+        QFile status("/proc/self/status");
+        if (status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            while (!status.atEnd()) {
+                const QByteArray line = status.readLine();
+                if (line.startsWith("VmHWM:")) {
+                    return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+                }
+            }
+        }
+#endif
+        return -1;
+    }
+
+    void ResetPeakRss()
+    {
+#ifdef Q_OS_LINUX
+        // 写 5 把 VmHWM 重置为当前 RSS，这样每个场景的峰值互不影响
+        QFile clearRefs("/proc/self/clear_refs");
+        if (clearRefs.open(QIODevice::WriteOnly)) {
+            clearRefs.write("5");
+        }
+#endif
+    }
+
+    struct Report {
+        int frames = 0;
+        int evaluated = 0;      // 已知真实滚动量、参与评估的帧
+        int correct = 0;
+        int wrong = 0;          // 给出了错误的滚动量
+        int lost = 0;           // 有重叠却没匹配上
+        int falseMotion = 0;    // 没滚动却报告了滚动
+        int retries = 0;        // 分段抓取衔接失败，要求抓整帧
+        qint64 grabbedPixels = 0;
+        qint64 framePixels = 0;
+        qint64 stitchNs = 0;
+        qint64 peakRssKb = -1;
+        qint64 segmentMemory = 0;
+        qint64 segmentDisk = 0;
+        int resultHeight = 0;
+        int expectedHeight = 0;
+        int rowsOk = 0;
+        // 全景场景
+        bool panorama = false;
+        int panoramaStartFrame = -1;   // 拼接器在第几帧切换到全景模式
+        int resultWidth = 0;
+        int expectedWidth = 0;
+        int thumbnails = 0;
+        qint64 thumbnailNs = 0;
+    };
+
+    // 逐行比较：差异超过容差的像素不超过一行的 10% 就算这一行正确（容忍噪声和小动画）
+    int CountMatchingRows(const QImage& result, const QImage& expected)
+    {
+        if (result.width() != expected.width()) {
+            return 0;
+        }
+        const int w = result.width();
+        const int rows = qMin(result.height(), expected.height());
+        int ok = 0;
+        for (int y = 0; y < rows; ++y) {
+            const QRgb* a = reinterpret_cast<const QRgb*>(result.constScanLine(y));
+            const QRgb* b = reinterpret_cast<const QRgb*>(expected.constScanLine(y));
+            int bad = 0;
+            for (int x = 0; x < w; ++x) {
+                if (qAbs(qRed(a[x]) - qRed(b[x])) > 16 ||
+                    qAbs(qGreen(a[x]) - qGreen(b[x])) > 16 ||
+                    qAbs(qBlue(a[x]) - qBlue(b[x])) > 16) {
+                    ++bad;
+                }
+            }
+            if (bad * 10 <= w) ++ok;
+        }
+        return ok;
+    }
+
+    QImage Compose(const SegmentStore& segments)
+    {
+        if (segments.isEmpty() || segments.totalHeight() > 200000) {
+            return QImage();
+        }
+        QImage out(segments.width(), int(segments.totalHeight()), QImage::Format_RGB32);
+        int y = 0;
+        for (int i = 0; i < segments.count(); ++i) {
+            const QImage seg = segments.at(i).convertToFormat(QImage::Format_RGB32);
+            CopyRows(out, y, seg, 0, seg.height());
+            y += seg.height();
+        }
+        return out;
+    }
+
+    struct Options {
+        bool band = false;
+        qint64 memoryBudget = 256ll * 1024 * 1024;
+        QString saveDir;
+    };
+
+    // 和 LongShotCapture::onTick 一致的分段抓取参数
+    constexpr int kMinProbeRows = 32;
+    constexpr int kMaxProbeRows = 128;
+    constexpr int kMinTailRows = 64;
+    constexpr int kTailMarginRows = 32;
+    // 和 LongShotWorker 的预览宽度一致
+    constexpr int kPanPreviewWidth = 480;
+
+    Report Replay(const FrameSource& source, const Options& options)
+    {
+        Report report;
+        ScrollStitcher stitcher;
+        SegmentStore segments(options.memoryBudget);
+        ResetPeakRss();
+
+        bool needFullFrame = true;
+        int lastMotionRows = 0;
+        qint64 refPos = -1;   // 拼接器参考帧对应的滚动位置
+        QElapsedTimer timer;
+
+        for (int i = 0; i < source.count(); ++i) {
+            const QImage frame = source.frame(i);
+            if (frame.isNull()) continue;
+            const int w = frame.width();
+            const int h = frame.height();
+            ++report.frames;
+            report.framePixels += qint64(w) * h;
+
+            const int header = stitcher.headerRows();
+            const int footer = stitcher.footerRows();
+            const int probeHeight = header + qBound(kMinProbeRows, h / 8, kMaxProbeRows);
+            const int tailHeight = qMax(kMinTailRows, lastMotionRows * 2 + kTailMarginRows) + footer;
+            const bool bandMode = options.band && !needFullFrame && i > 0 && probeHeight + tailHeight < h;
+
+            ScrollStitcher::Result result;
+            if (bandMode) {
+                // 模拟只抓两条：从整帧里切出来，只统计真正需要抓的像素
+                const QImage probe = frame.copy(0, 0, w, probeHeight);
+                const QImage tail = frame.copy(0, h - tailHeight, w, tailHeight);
+                report.grabbedPixels += qint64(w) * (probeHeight + tailHeight);
+                timer.start();
+                result = stitcher.pushBand(probe, tail);
+                report.stitchNs += timer.nsecsElapsed();
+            }
+            else {
+                report.grabbedPixels += qint64(w) * h;
+                needFullFrame = false;
+                timer.start();
+                result = stitcher.push(frame);
+                report.stitchNs += timer.nsecsElapsed();
+            }
+
+            timer.start();
+            if (!result.band.isNull()) segments.append(result.band);
+            report.stitchNs += timer.nsecsElapsed();
+
+            // 和 LongShotWorker 一样换算滚动行数，决定下一次底部条抓多高
+            if (result.needFullFrame) {
+                needFullFrame = true;
+                ++report.retries;
+                lastMotionRows = result.changed ? h * 3 / 4 : 0;
+                continue;
+            }
+            lastMotionRows = !result.changed ? 0 : (result.overlapLost ? h : result.match.offset);
+
+            // ---- 和真实滚动量对比 ----
+            const qint64 pos = source.position(i);
+            if (i > 0 && pos >= 0 && refPos >= 0) {
+                const qint64 truth = pos - refPos;
+                const int region = h - source.headerRows() - source.footerRows();
+                ++report.evaluated;
+                if (truth == 0) {
+                    if (!result.changed || (result.match.matched && result.match.offset == 0)) ++report.correct;
+                    else ++report.falseMotion;
+                }
+                else if (truth > region - 8) {
+                    // 滚过一屏，本来就没有重叠，能识别出来就算对
+                    if (result.changed && !result.match.matched) ++report.correct;
+                    else ++report.wrong;
+                }
+                else if (!result.changed || !result.match.matched) {
+                    ++report.lost;
+                }
+                else if (result.match.offset == truth) {
+                    ++report.correct;
+                }
+                else {
+                    ++report.wrong;
+                }
+            }
+            if (i == 0 || result.changed) {
+                refPos = pos;
+            }
+        }
+
+        timer.start();
+        segments.append(stitcher.finish());
+        report.stitchNs += timer.nsecsElapsed();
+
+        report.peakRssKb = PeakRssKb();
+        report.segmentMemory = segments.memoryUsage();
+        report.segmentDisk = segments.diskUsage();
+
+        const QImage result = Compose(segments);
+        const QImage expected = source.expected();
+        report.resultHeight = int(segments.totalHeight());
+        report.expectedHeight = expected.height();
+        if (!result.isNull() && !expected.isNull()) {
+            report.rowsOk = CountMatchingRows(result, expected);
+        }
+
+        if (!options.saveDir.isEmpty() && !segments.isEmpty()) {
+            // 和 LongShotCapture 导出一样逐段流式编码，顺带在离线环境里检查 StreamingPngWriter
+            QDir().mkpath(options.saveDir);
+            StreamingPngWriter writer;
+            bool saved = writer.open(QDir(options.saveDir).filePath(source.name() + ".png"),
+                segments.width(), segments.totalHeight());
+            for (int i = 0; saved && i < segments.count(); ++i) {
+                saved = writer.writeRows(segments.at(i));
+            }
+            saved = saved && writer.close();
+            if (!saved) {
+                qWarning() << "[Replay] save failed:" << writer.errorString();
+            }
+        }
+        return report;
+    }
+
+    // ---------------- 全景场景（横向 / 斜向平移） ----------------
+
+    struct PanSpec {
+        const char* name;
+        int minDx;
+        int maxDx;
+        int minDy;
+        int maxDy;
+        double pauseChance;
+    };
+
+    const PanSpec kPanScenarios[] = {
+        { "pan",      40, 240,  0,   0, 0.10 },
+        { "diagonal", 30, 160, 10,  60, 0.10 },
+    };
+
+    // 在比视口大得多的二维文档上来回平移：碰到左右边缘就掉头并下移三分之一屏，
+    // 所以既有纯横向、斜向，也有纯纵向的移动；第一次移动一定带横向分量，好让拼接器进入全景模式
+    class PanSource
+    {
+    public:
+        PanSource(const PanSpec& spec, const QSize& viewport, quint32 seed)
+            : spec_(spec), viewport_(viewport)
+        {
+            page_ = MakePage(viewport.width() * 4, viewport.height() * 3, seed);
+
+            QRandomGenerator rng(seed ^ 0xA5A5A5A5u);
+            const QPoint maxPos(page_.width() - viewport.width(), page_.height() - viewport.height());
+            QPoint pos(0, 0);
+            int dir = 1;
+            positions_.push_back(pos);
+            while (positions_.size() < 400) {
+                QPoint step(dir * rng.bounded(spec.minDx, spec.maxDx + 1),
+                    spec.maxDy > 0 ? rng.bounded(spec.minDy, spec.maxDy + 1) : 0);
+                if (positions_.size() > 1 && rng.generateDouble() < spec.pauseChance) {
+                    step = QPoint(0, 0);
+                }
+                QPoint next = pos + step;
+                if (next.x() < 0 || next.x() > maxPos.x()) {
+                    next = QPoint(qBound(0, next.x(), maxPos.x()), pos.y() + viewport.height() / 3);
+                    dir = -dir;
+                }
+                if (next.y() > maxPos.y()) {
+                    break;
+                }
+                pos = next;
+                positions_.push_back(pos);
+            }
+            for (int i = 0; i < 3; ++i) {
+                positions_.push_back(pos);
+            }
+        }
+
+        QString name() const { return QString::fromLatin1(spec_.name); }
+        int count() const { return positions_.size(); }
+        QPoint position(int index) const { return positions_[index]; }
+        QImage frame(int index) const { return page_.copy(QRect(positions_[index], viewport_)); }
+
+        // 所有视口覆盖过的区域，没看到的地方是白色（和导出时一样）
+        QImage expected(QRect* bounds) const
+        {
+            QRect all;
+            for (const QPoint& p : positions_) all |= QRect(p, viewport_);
+            QImage out(all.size(), QImage::Format_RGB32);
+            out.fill(Qt::white);
+            for (int i = 0; i < positions_.size(); ++i) {
+                const QPoint p = positions_[i];
+                const QImage view = frame(i);
+                for (int y = 0; y < view.height(); ++y) {
+                    memcpy(out.scanLine(p.y() - all.top() + y) + (p.x() - all.left()) * 4,
+                        view.constScanLine(y), size_t(view.width()) * 4);
+                }
+            }
+            *bounds = all;
+            return out;
+        }
+
+    private:
+        PanSpec spec_;
+        QSize viewport_;
+        QImage page_;
+        QVector<QPoint> positions_;
+    };
+
+    // 和 LongShotWorker 的全景路径一致：整帧 push，placements 贴到 PanoramaCanvas，
+    // 每次贴图后取一次预览缩略图；评估 2D 偏移，并把拼出的画布和所有视口覆盖区域逐行比较
+    Report ReplayPanorama(const PanSource& source, const Options& options)
+    {
+        Report report;
+        report.panorama = true;
+        ScrollStitcher stitcher;
+        PanoramaCanvas canvas;
+        ResetPeakRss();
+
+        QPoint refPos = source.position(0);
+        QElapsedTimer timer;
+        for (int i = 0; i < source.count(); ++i) {
+            const QImage frame = source.frame(i);
+            ++report.frames;
+            report.framePixels += qint64(frame.width()) * frame.height();
+            report.grabbedPixels += qint64(frame.width()) * frame.height();
+
+            timer.start();
+            const ScrollStitcher::Result result = stitcher.push(frame);
+            for (const ScrollStitcher::Result::Placement& placed : result.placements) {
+                canvas.paste(placed.image, placed.pos);
+            }
+            report.stitchNs += timer.nsecsElapsed();
+            if (result.panoramaStarted) {
+                report.panoramaStartFrame = i;
+            }
+            if (!result.placements.isEmpty()) {
+                timer.start();
+                const QImage thumb = canvas.thumbnail(QSize(kPanPreviewWidth, kPanPreviewWidth * 2));
+                report.thumbnailNs += timer.nsecsElapsed();
+                ++report.thumbnails;
+                Q_UNUSED(thumb);
+            }
+
+            if (i == 0) continue;
+            const QPoint truth = source.position(i) - refPos;
+            ++report.evaluated;
+            if (truth.isNull()) {
+                if (!result.changed || (result.match.matched && result.match.offset == 0 && result.match.offsetX == 0)) ++report.correct;
+                else ++report.falseMotion;
+            }
+            else if (!result.changed || !result.match.matched) {
+                ++report.lost;
+            }
+            else if (QPoint(result.match.offsetX, result.match.offset) == truth) {
+                ++report.correct;
+            }
+            else {
+                ++report.wrong;
+            }
+            // 没匹配上的帧会被丢掉，参考帧不变
+            if (result.changed && result.match.matched) {
+                refPos = source.position(i);
+            }
+        }
+        stitcher.finish();
+
+        report.peakRssKb = PeakRssKb();
+        report.segmentMemory = canvas.memoryUsage();
+
+        QRect expectedBounds;
+        const QImage expected = source.expected(&expectedBounds);
+        const QRect bounds = canvas.bounds();
+        report.resultHeight = bounds.height();
+        report.expectedHeight = expected.height();
+        report.resultWidth = bounds.width();
+        report.expectedWidth = expected.width();
+        const QImage result = canvas.copy(bounds).convertToFormat(QImage::Format_RGB32);
+        if (!result.isNull()) {
+            report.rowsOk = CountMatchingRows(result, expected);
+        }
+
+        if (!options.saveDir.isEmpty() && !result.isNull()) {
+            // 和导出一样按 tile 行切条流式写出
+            QDir().mkpath(options.saveDir);
+            StreamingPngWriter writer;
+            bool saved = writer.open(QDir(options.saveDir).filePath(source.name() + ".png"), bounds.width(), bounds.height());
+            for (int y = bounds.top(); saved && y <= bounds.bottom(); y += PanoramaCanvas::kTileSize) {
+                const int rows = qMin(PanoramaCanvas::kTileSize, bounds.bottom() - y + 1);
+                saved = writer.writeRows(canvas.copy(QRect(bounds.left(), y, bounds.width(), rows)));
+            }
+            saved = saved && writer.close();
+            if (!saved) {
+                qWarning() << "[Replay] save failed:" << writer.errorString();
+            }
+        }
+        return report;
+    }
+
+    void PrintHeader(QTextStream& out)
+    {
+        out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12\n")
+            .arg(QStringLiteral("scenario"), -10).arg(QStringLiteral("mode"), -5).arg(QStringLiteral("frames"), 6).arg(QStringLiteral("correct"), 8)
+            .arg(QStringLiteral("wrong"), 6).arg(QStringLiteral("lost"), 5).arg(QStringLiteral("false"), 6).arg(QStringLiteral("retry"), 6)
+            .arg(QStringLiteral("rows-ok"), 8).arg(QStringLiteral("height"), 13).arg(QStringLiteral("fps"), 8).arg(QStringLiteral("peak-rss"), 9);
+    }
+
+    void PrintReport(QTextStream& out, const QString& name, const Options& options, const Report& r)
+    {
+        const double accuracy = r.evaluated ? 100.0 * r.correct / r.evaluated : 0;
+        const int rowsTotal = qMax(r.resultHeight, r.expectedHeight);
+        const QString rows = r.expectedHeight > 0 && rowsTotal > 0
+            ? QString::number(100.0 * r.rowsOk / rowsTotal, 'f', 1) + "%"
+            : QString("-");
+        const QString height = r.expectedHeight > 0
+            ? QString("%1/%2").arg(r.resultHeight).arg(r.expectedHeight)
+            : QString::number(r.resultHeight);
+        const QString mode = r.panorama ? QStringLiteral("pan")
+            : options.band ? QStringLiteral("band") : QStringLiteral("full");
+        const double fps = r.stitchNs > 0 ? r.frames * 1e9 / r.stitchNs : 0;
+        const QString rss = r.peakRssKb >= 0 ? QString("%1M").arg(r.peakRssKb / 1024) : QString("-");
+
+        out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12\n")
+            .arg(name, -10).arg(mode, -5).arg(r.frames, 6)
+            .arg(QString::number(accuracy, 'f', 1) + "%", 8)
+            .arg(r.wrong, 6).arg(r.lost, 5).arg(r.falseMotion, 6).arg(r.retries, 6)
+            .arg(rows, 8).arg(height, 13).arg(fps, 8, 'f', 0).arg(rss, 9);
+        if (r.panorama) {
+            out << QString("%1   panorama from frame %2, width %3/%4, canvas %5 KB, thumbnail %6 us avg over %7 updates\n")
+                .arg(QStringLiteral(""), -10).arg(r.panoramaStartFrame).arg(r.resultWidth).arg(r.expectedWidth)
+                .arg(r.segmentMemory / 1024).arg(r.thumbnails ? r.thumbnailNs / 1000 / r.thumbnails : 0).arg(r.thumbnails);
+        }
+        else if (options.band && r.framePixels > 0) {
+            out << QString("%1   grabbed %2% of frame pixels, segments %3 KB in memory / %4 KB on disk\n")
+                .arg(QStringLiteral(""), -10).arg(100.0 * r.grabbedPixels / r.framePixels, 0, 'f', 1)
+                .arg(r.segmentMemory / 1024).arg(r.segmentDisk / 1024);
+        }
+        out.flush();
+    }
+
+    bool g_verbose = false;
+
+    void MessageFilter(QtMsgType type, const QMessageLogContext&, const QString& msg)
+    {
+        // 拼接器每帧都会打 qDebug，默认只保留警告以上
+        if (type == QtDebugMsg && !g_verbose) {
+            return;
+        }
+        QTextStream(stderr) << msg << '\n';
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // 只用到 QImage，默认走 offscreen 平台，没有显示器也能跑
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    qInstallMessageHandler(MessageFilter);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays long-shot frame sequences through ScrollStitcher "
+        "and reports stitch accuracy, throughput and peak memory.");
+    parser.addHelpOption();
+    QCommandLineOption scenarioOpt("scenario", "Synthetic scenario to run (steady, variable, noise, "
+        "sticky, animated, jumps, pan, diagonal or all).", "name", "all");
+    QCommandLineOption framesOpt("frames", "Replay a recorded PNG sequence from <dir> instead "
+        "(optional offsets.txt and expected.png next to the frames).", "dir");
+    QCommandLineOption bandOpt("band", "Simulate band grabbing (probe strip + revealed tail) like the live capture.");
+    QCommandLineOption sizeOpt("size", "Viewport size for synthetic scenarios.", "WxH", "800x600");
+    QCommandLineOption pageOpt("page-height", "Document height for synthetic scenarios.", "rows", "12000");
+    QCommandLineOption seedOpt("seed", "Random seed for synthetic scenarios.", "n", "1");
+    QCommandLineOption budgetOpt("budget", "Segment store memory budget in MB.", "mb", "256");
+    QCommandLineOption saveOpt("save", "Save each stitched result as PNG into <dir>.", "dir");
+    QCommandLineOption verboseOpt("verbose", "Show the stitcher's per-frame debug output.");
+    parser.addOptions({ scenarioOpt, framesOpt, bandOpt, sizeOpt, pageOpt, seedOpt, budgetOpt, saveOpt, verboseOpt });
+    parser.process(app);
+
+    g_verbose = parser.isSet(verboseOpt);
+
+    Options options;
+    options.band = parser.isSet(bandOpt);
+    options.memoryBudget = parser.value(budgetOpt).toLongLong() * 1024 * 1024;
+    options.saveDir = parser.value(saveOpt);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    std::vector<std::unique_ptr<FrameSource>> sources;
+    std::vector<std::unique_ptr<PanSource>> panSources;
+    if (parser.isSet(framesOpt)) {
+        auto recorded = std::make_unique<RecordedSource>(parser.value(framesOpt));
+        if (recorded->count() == 0) {
+            err << "no PNG frames found in " << parser.value(framesOpt) << '\n';
+            return 1;
+        }
+        sources.push_back(std::move(recorded));
+    }
+    else {
+        const QStringList wh = parser.value(sizeOpt).split('x');
+        const QSize viewport(wh.value(0).toInt(), wh.value(1).toInt());
+        const int pageHeight = parser.value(pageOpt).toInt();
+        if (viewport.width() < 200 || viewport.height() < 200 || pageHeight < viewport.height()) {
+            err << "invalid --size or --page-height\n";
+            return 1;
+        }
+        const QString wanted = parser.value(scenarioOpt);
+        for (const ScenarioSpec& spec : kScenarios) {
+            if (wanted == QLatin1String("all") || wanted == QLatin1String(spec.name)) {
+                sources.push_back(std::make_unique<SyntheticSource>(spec, viewport, pageHeight,
+                    parser.value(seedOpt).toUInt()));
+            }
+        }
+        // 全景场景只接受整帧，--band 和 --page-height 对它们不起作用
+        for (const PanSpec& spec : kPanScenarios) {
+            if (wanted == QLatin1String("all") || wanted == QLatin1String(spec.name)) {
+                panSources.push_back(std::make_unique<PanSource>(spec, viewport, parser.value(seedOpt).toUInt()));
+            }
+        }
+        if (sources.empty() && panSources.empty()) {
+            err << "unknown scenario " << wanted << '\n';
+            return 1;
+        }
+    }
+
+    PrintHeader(out);
+    for (const auto& source : sources) {
+        PrintReport(out, source->name(), options, Replay(*source, options));
+    }
+    for (const auto& source : panSources) {
+        PrintReport(out, source->name(), options, ReplayPanorama(*source, options));
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// 马赛克块求和基准：对 5-50 的块大小和从小选区到 4K 的区域，
+// 对比 MosaicTool::applyEffect（按扫描行累加）和旧实现（QImage::pixel + 逐块 fillRect）的耗时，
+// 并用逐块直接求平均的参考实现校验输出。默认走 offscreen 平台：
+//   ./mosaic_bench --blocks 5,10,20,50 --areas 640x480,1920x1080,3840x2160
+#include "MosaicTool.h"
+#include "bench_util.h"
+
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+
+namespace {
+
+    // 类似屏幕内容的测试图：渐变底色 + 随机色块 + 细线文字感的噪点
+    QImage MakeImage(const QSize& size, quint32 seed)
+    {
+        QImage image(size, QImage::Format_ARGB32_Premultiplied);
+        QRandomGenerator rng(seed);
+        for (int y = 0; y < size.height(); ++y) {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < size.width(); ++x) {
+                line[x] = qRgb((x * 255) / qMax(1, size.width()), (y * 255) / qMax(1, size.height()), 200);
+            }
+        }
+        for (int i = 0; i < 2000; ++i) {
+            const int x = rng.bounded(size.width());
+            const int y = rng.bounded(size.height());
+            const int w = qMin(size.width() - x, rng.bounded(1, 40));
+            const QRgb ink = qRgb(rng.bounded(256), rng.bounded(256), rng.bounded(256));
+            std::fill_n(reinterpret_cast<QRgb*>(image.scanLine(y)) + x, w, ink);
+        }
+        return image;
+    }
+
+    // 旧实现：整张 pixmap 转 QImage，逐像素 pixel() 求和，再逐块 fillRect
+    void LegacyMosaic(QPixmap& pixmap, const QRect& area, int blockSize)
+    {
+        QPainter painter(&pixmap);
+        const QImage image = pixmap.toImage();
+        const QRect effectiveArea = area.intersected(pixmap.rect());
+        for (int y = effectiveArea.top(); y < effectiveArea.bottom(); y += blockSize) {
+            for (int x = effectiveArea.left(); x < effectiveArea.right(); x += blockSize) {
+                const QRect blockRect = QRect(x, y, blockSize, blockSize).intersected(effectiveArea);
+                int r = 0, g = 0, b = 0, a = 0, n = 0;
+                for (int by = blockRect.top(); by < blockRect.bottom(); ++by) {
+                    for (int bx = blockRect.left(); bx < blockRect.right(); ++bx) {
+                        const QRgb pixel = image.pixel(bx, by);
+                        r += qRed(pixel); g += qGreen(pixel); b += qBlue(pixel); a += qAlpha(pixel);
+                        ++n;
+                    }
+                }
+                if (n > 0) {
+                    painter.fillRect(blockRect, QColor(r / n, g / n, b / n, a / n));
+                }
+            }
+        }
+    }
+
+    // 参考实现：每块独立求和、四舍五入取平均，只用来校验输出
+    QImage ReferenceMosaic(const QImage& source, const QRect& area, int blockSize)
+    {
+        QImage out = source.copy();
+        for (int by = area.top(); by <= area.bottom(); by += blockSize) {
+            for (int bx = area.left(); bx <= area.right(); bx += blockSize) {
+                const QRect block = QRect(bx, by, blockSize, blockSize).intersected(area);
+                quint32 s[4] = { 0, 0, 0, 0 };
+                for (int y = block.top(); y <= block.bottom(); ++y) {
+                    const QRgb* line = reinterpret_cast<const QRgb*>(source.constScanLine(y));
+                    for (int x = block.left(); x <= block.right(); ++x) {
+                        s[0] += qAlpha(line[x]); s[1] += qRed(line[x]); s[2] += qGreen(line[x]); s[3] += qBlue(line[x]);
+                    }
+                }
+                const quint32 n = quint32(block.width() * block.height());
+                const QRgb avg = qRgba((s[1] + n / 2) / n, (s[2] + n / 2) / n, (s[3] + n / 2) / n, (s[0] + n / 2) / n);
+                for (int y = block.top(); y <= block.bottom(); ++y) {
+                    QRgb* line = reinterpret_cast<QRgb*>(out.scanLine(y));
+                    std::fill(line + block.left(), line + block.right() + 1, avg);
+                }
+            }
+        }
+        return out;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchUtil::UseOffscreenByDefault();
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times MosaicTool's scanline block sums against the old "
+        "per-pixel implementation for a range of block sizes and areas.");
+    parser.addHelpOption();
+    QCommandLineOption blocksOpt("blocks", "Comma-separated block sizes (5-50).", "list", "5,10,15,20,30,40,50");
+    QCommandLineOption areasOpt("areas", "Comma-separated area sizes, up to 4K.", "list",
+        "256x256,640x480,1920x1080,3840x2160");
+    QCommandLineOption runsOpt("runs", "Repetitions per case (median is reported).", "n", "5");
+    QCommandLineOption noLegacyOpt("no-legacy", "Skip the old per-pixel implementation.");
+    parser.addOptions({ blocksOpt, areasOpt, runsOpt, noLegacyOpt });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QVector<int> blocks = BenchUtil::ParseInts(parser.value(blocksOpt));
+    const QVector<QSize> areas = BenchUtil::ParseSizes(parser.value(areasOpt));
+    const int runs = qMax(1, parser.value(runsOpt).toInt());
+    const bool legacy = !parser.isSet(noLegacyOpt);
+    for (int b : blocks) {
+        if (b < 5 || b > 50) {
+            err << "block size " << b << " is outside 5-50\n";
+            return BenchUtil::kExitUsage;
+        }
+    }
+    for (const QSize& s : areas) {
+        if (s.isEmpty() || s.width() > 3840 || s.height() > 2160) {
+            err << "area " << s.width() << 'x' << s.height() << " is empty or larger than 4K\n";
+            return BenchUtil::kExitUsage;
+        }
+    }
+
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+        .arg(QStringLiteral("area"), -10).arg(QStringLiteral("block"), 5).arg(QStringLiteral("scan-us"), 9)
+        .arg(QStringLiteral("Mpx/s"), 8).arg(QStringLiteral("legacy-us"), 10).arg(QStringLiteral("speedup"), 8);
+
+    bool allMatch = true;
+    for (const QSize& size : areas) {
+        // 选区放在更大的画布中间，和编辑器里一样只处理画布的一部分
+        const QImage source = MakeImage(size + QSize(64, 64), 7);
+        const QRect area(QPoint(32, 32), size);
+        const QPixmap sourcePixmap = legacy ? QPixmap::fromImage(source) : QPixmap();
+
+        for (int block : blocks) {
+            QImage result;
+            // 每次先恢复原图（不计时）
+            const qint64 scanUs = BenchUtil::MedianUs(runs,
+                [&] { result = source.copy(); },
+                [&] { MosaicTool::applyEffect(result, area, block); });
+            if (result != ReferenceMosaic(source, area, block)) {
+                allMatch = false;
+                err << "mismatch at area " << size.width() << 'x' << size.height() << " block " << block << '\n';
+            }
+
+            qint64 legacyUs = 0;
+            if (legacy) {
+                QPixmap pixmap;
+                legacyUs = BenchUtil::MedianUs(runs,
+                    [&] { pixmap = sourcePixmap.copy(); },
+                    [&] { LegacyMosaic(pixmap, area, block); });
+            }
+
+            const double mpx = double(size.width()) * size.height() / qMax<qint64>(1, scanUs);
+            out << QString("%1 %2 %3 %4 %5 %6\n")
+                .arg(QString("%1x%2").arg(size.width()).arg(size.height()), -10).arg(block, 5)
+                .arg(scanUs, 9).arg(mpx, 8, 'f', 1)
+                .arg(legacy ? QString::number(legacyUs) : QStringLiteral("-"), 10)
+                .arg(legacy ? QString::number(double(legacyUs) / qMax<qint64>(1, scanUs), 'f', 1) + 'x' : QStringLiteral("-"), 8);
+        }
+    }
+    return BenchUtil::ReportMatch(out, "output matches per-block reference", allMatch);
+}
@@ -0,0 +1,18 @@
+# 马赛克块求和基准：MosaicTool 带设置面板，所以需要 widgets 模块；运行时不创建任何窗口
+TEMPLATE = app
+TARGET = mosaic_bench
+QT = core gui widgets
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SRC_DIR = $$PWD/../../src
+
+INCLUDEPATH += "$$SRC_DIR/Head Files" $$PWD/../common
+
+HEADERS += \
+    $$PWD/../common/bench_util.h \
+    "$$SRC_DIR/Head Files/MosaicTool.h"
+
+SOURCES += \
+    main.cpp \
+    "$$SRC_DIR/Resources files/MosaicTool.cpp"
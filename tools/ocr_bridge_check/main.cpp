@@ -0,0 +1,203 @@
+// OCR 图像桥接检查：把每种常见的 QImage 格式喂给 OcrImageBridge::toBgr，
+// 核对统计计数（零拷贝 / cvtColor / Qt 转换 / 缓冲区重分配）、同尺寸连续调用时缓冲区复用，
+// 以及输出的 BGR 像素和 QImage::pixel() 一致。任何一项不符都以非零退出码结束：
+//   ./ocr_bridge_check --size 1920x1080 --runs 20
+#include "OcrImageBridge.h"
+#include "bench_util.h"
+
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QImage>
+#include <QTextStream>
+
+namespace {
+
+    struct FormatCase {
+        const char* name;
+        QImage::Format format;
+        bool zeroCopy;       // 直接包装返回，不做任何转换
+        bool qtConversion;   // 桥接不支持，先经 QImage::convertToFormat
+    };
+
+    const FormatCase kCases[] = {
+        { "BGR888", QImage::Format_BGR888, true, false },
+        { "RGB888", QImage::Format_RGB888, false, false },
+        { "RGB32", QImage::Format_RGB32, false, false },
+        { "ARGB32", QImage::Format_ARGB32, false, false },
+        { "ARGB32_Premultiplied", QImage::Format_ARGB32_Premultiplied, false, false },
+        { "Grayscale8", QImage::Format_Grayscale8, false, false },
+        { "RGB16", QImage::Format_RGB16, false, true },
+        { "Indexed8", QImage::Format_Indexed8, false, true },
+    };
+
+    // 不透明的测试图：三个通道各自不同的渐变，换错通道顺序一定能看出来
+    QImage MakeImage(const QSize& size, QImage::Format format)
+    {
+        QImage image(size, QImage::Format_RGB32);
+        for (int y = 0; y < size.height(); ++y) {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < size.width(); ++x) {
+                line[x] = qRgb((x * 7) & 0xFF, (y * 3) & 0xFF, (x + y * 5) & 0xFF);
+            }
+        }
+        return image.convertToFormat(format);
+    }
+
+    // 输出逐像素和 QImage::pixel() 比较；pixel() 对所有格式都返回 (A)RGB，不透明图上与 BGR 一一对应
+    bool SamePixels(const QImage& image, const cv::Mat& bgr)
+    {
+        if (bgr.type() != CV_8UC3 || bgr.rows != image.height() || bgr.cols != image.width()) {
+            return false;
+        }
+        for (int y = 0; y < image.height(); ++y) {
+            const uchar* row = bgr.ptr<uchar>(y);
+            for (int x = 0; x < image.width(); ++x) {
+                const QRgb px = image.pixel(x, y);
+                if (row[3 * x] != qBlue(px) || row[3 * x + 1] != qGreen(px) || row[3 * x + 2] != qRed(px)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool SameStats(const OcrImageBridge::Stats& a, const OcrImageBridge::Stats& b)
+    {
+        return a.zeroCopy == b.zeroCopy && a.converted == b.converted
+            && a.qtConversions == b.qtConversions && a.bufferReallocs == b.bufferReallocs;
+    }
+
+    QString StatsText(const OcrImageBridge::Stats& s)
+    {
+        return QString("zeroCopy=%1 converted=%2 qtConversions=%3 bufferReallocs=%4")
+            .arg(s.zeroCopy).arg(s.converted).arg(s.qtConversions).arg(s.bufferReallocs);
+    }
+
+    // 一种格式的完整检查：同尺寸调两次、再换一个尺寸调一次，每一步都核对计数和像素
+    bool CheckFormat(const FormatCase& c, const QSize& size, QTextStream& err)
+    {
+        bool ok = true;
+        auto fail = [&](const QString& what) {
+            err << c.name << ": " << what << '\n';
+            ok = false;
+        };
+
+        OcrImageBridge bridge;
+        OcrImageBridge::Stats expected;
+        const QImage first = MakeImage(size, c.format);
+        const QImage second = MakeImage(size, c.format);
+        // 换一个尺寸，转换路径必须重新分配缓冲区；宽度仍是奇数（默认 97），
+        // 24 / 8 位格式的 bytesPerLine 带对齐填充，顺带检查 Mat 的步长
+        const QImage resized = MakeImage(size + QSize(2, 1), c.format);
+
+        const cv::Mat a = bridge.toBgr(first);
+        const uchar* firstData = a.data;
+        if (c.zeroCopy) {
+            ++expected.zeroCopy;
+            if (a.data != first.constBits()) {
+                fail("zero-copy result does not point at the image pixels");
+            }
+        }
+        else {
+            ++expected.converted;
+            ++expected.bufferReallocs;
+            expected.qtConversions += c.qtConversion ? 1 : 0;
+        }
+        if (!SameStats(bridge.stats(), expected)) {
+            fail("first call: " + StatsText(bridge.stats()) + ", expected " + StatsText(expected));
+        }
+        if (!SamePixels(first, a)) {
+            fail("first call: pixels differ");
+        }
+
+        // 同尺寸同格式：转换路径必须复用上一次的缓冲区
+        const cv::Mat b = bridge.toBgr(second);
+        if (c.zeroCopy) {
+            ++expected.zeroCopy;
+        }
+        else {
+            ++expected.converted;
+            expected.qtConversions += c.qtConversion ? 1 : 0;
+            if (b.data != firstData) {
+                fail("same-size call did not reuse the buffer");
+            }
+        }
+        if (!SameStats(bridge.stats(), expected)) {
+            fail("same-size call: " + StatsText(bridge.stats()) + ", expected " + StatsText(expected));
+        }
+        if (!SamePixels(second, b)) {
+            fail("same-size call: pixels differ");
+        }
+
+        const cv::Mat r = bridge.toBgr(resized);
+        if (c.zeroCopy) {
+            ++expected.zeroCopy;
+        }
+        else {
+            ++expected.converted;
+            ++expected.bufferReallocs;
+            expected.qtConversions += c.qtConversion ? 1 : 0;
+        }
+        if (!SameStats(bridge.stats(), expected)) {
+            fail("resized call: " + StatsText(bridge.stats()) + ", expected " + StatsText(expected));
+        }
+        if (!SamePixels(resized, r)) {
+            fail("resized call: pixels differ");
+        }
+        return ok;
+    }
+
+    // 同一个桥接实例连续转换同尺寸图的中位耗时，对应 OCR 时每次识别的输入准备开销
+    qint64 ConvertMedianUs(const FormatCase& c, const QSize& size, int runs)
+    {
+        OcrImageBridge bridge;
+        const QImage image = MakeImage(size, c.format);
+        return BenchUtil::MedianUs(runs, [&] {
+            const cv::Mat bgr = bridge.toBgr(image);
+            Q_UNUSED(bgr);
+            });
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchUtil::UseOffscreenByDefault();
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Feeds every common QImage format through OcrImageBridge::toBgr, checks "
+        "the copy / conversion / reallocation counters and the BGR pixels, and times each path.");
+    parser.addHelpOption();
+    QCommandLineOption checkSizeOpt("check-size", "Image size for the counter and pixel checks.", "WxH", "97x61");
+    QCommandLineOption sizeOpt("size", "Image size for the timing column.", "WxH", "1920x1080");
+    QCommandLineOption runsOpt("runs", "Conversions per format for the timing column (median is reported).", "n", "20");
+    parser.addOptions({ checkSizeOpt, sizeOpt, runsOpt });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QSize checkSize = BenchUtil::ParseSize(parser.value(checkSizeOpt));
+    const QSize size = BenchUtil::ParseSize(parser.value(sizeOpt));
+    const int runs = qMax(1, parser.value(runsOpt).toInt());
+    if (checkSize.isEmpty() || size.isEmpty()) {
+        err << "invalid --check-size or --size\n";
+        return BenchUtil::kExitUsage;
+    }
+
+    out << QString("%1 %2 %3 %4\n")
+        .arg(QStringLiteral("format"), -22).arg(QStringLiteral("path"), -10).arg(QStringLiteral("check"), 6)
+        .arg(QString("us@%1x%2").arg(size.width()).arg(size.height()), 14);
+    bool allOk = true;
+    for (const FormatCase& c : kCases) {
+        const bool ok = CheckFormat(c, checkSize, err);
+        allOk = allOk && ok;
+        const QString path = c.zeroCopy ? QStringLiteral("zero-copy")
+            : c.qtConversion ? QStringLiteral("qt+cvt") : QStringLiteral("cvt");
+        out << QString("%1 %2 %3 %4\n")
+            .arg(QString::fromLatin1(c.name), -22).arg(path, -10).arg(ok ? QStringLiteral("ok") : QStringLiteral("FAIL"), 6)
+            .arg(ConvertMedianUs(c, size, runs), 14);
+    }
+    return BenchUtil::ReportMatch(out, "all formats pass", allOk);
+}
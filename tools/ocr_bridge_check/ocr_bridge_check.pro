@@ -0,0 +1,29 @@
+# OCR 图像桥接检查：只编译 OcrImageBridge，需要 OpenCV（core + imgproc），不依赖 Paddle
+TEMPLATE = app
+TARGET = ocr_bridge_check
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SRC_DIR = $$PWD/../../src
+
+INCLUDEPATH += "$$SRC_DIR/Head Files" $$PWD/../common
+
+HEADERS += \
+    $$PWD/../common/bench_util.h \
+    "$$SRC_DIR/Head Files/OcrImageBridge.h"
+
+SOURCES += \
+    main.cpp \
+    "$$SRC_DIR/Resources files/OcrImageBridge.cpp"
+
+# Windows 下用和主工程相同的 3rdparty/cpp/opencv 预编译包，其它平台用系统 OpenCV（pkg-config）
+win32 {
+    INCLUDEPATH += $$PWD/../../3rdparty/cpp/opencv/opencv/build/include
+    LIBS += -L$$PWD/../../3rdparty/cpp/opencv/opencv/build/x64/vc16/lib
+    CONFIG(debug, debug|release): LIBS += -lopencv_world470d
+    else: LIBS += -lopencv_world470
+} else {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += opencv4
+}
@@ -0,0 +1,314 @@
+// 大图 OCR 切片基准：在合成的长页面上跑 OcrTiler 的切片规划和按检测框位置的合并，
+// 用模拟的检测结果（每片只报告落在片内的框，被切口截断的框按可见部分报告）校验合并后
+// 每一行恰好出现一次、且保留的是完整的框，再用 1..N 个实例并行识别切片（每个实例的推理
+// 本身也是多线程，工作量按切片面积计），对比档位原始线程数和按实例池均分后的墙钟时间。默认走 offscreen 平台：
+//   ./ocr_tiling_bench --scenarios tall-gaps,tall-dense,wide --threads 1,2,4 --profile balanced
+#include "OcrProfile.h"
+#include "OcrTiler.h"
+#include "bench_util.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QHash>
+#include <QImage>
+#include <QPolygon>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QThread>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // 一种合成页面：长边方向排满文字行，gaps 控制行间是否留有空白
+    struct Scenario {
+        const char* name;
+        QSize size;
+        bool gaps;           // true：行间是纯色空白，切口能落在空白上；false：满屏噪点，只能重叠切
+        int lineHeight;
+        int wordMin;         // 单个检测框沿行方向的长度范围
+        int wordMax;
+    };
+
+    const Scenario kScenarios[] = {
+        { "tall-gaps", QSize(1920, 20000), true, 24, 120, 600 },
+        { "tall-dense", QSize(1920, 20000), false, 24, 120, 600 },
+        { "wide", QSize(8000, 900), false, 24, 40, 90 },
+    };
+
+    struct Page {
+        QImage image;
+        QVector<OcrLine> truth;   // 原图坐标下的真实检测框，text 唯一
+    };
+
+    // 浅色底 + 深色文字块；dense 时底色逐像素加噪，让每一行 / 列都不安静
+    Page MakePage(const Scenario& s, quint32 seed)
+    {
+        QRandomGenerator rng(seed);
+        Page page;
+        page.image = QImage(s.size, QImage::Format_RGB32);
+        for (int y = 0; y < s.size.height(); ++y) {
+            QRgb* line = reinterpret_cast<QRgb*>(page.image.scanLine(y));
+            for (int x = 0; x < s.size.width(); ++x) {
+                const int g = s.gaps ? 240 : 200 + int(rng.bounded(56));
+                line[x] = qRgb(g, g, g);
+            }
+        }
+
+        const int pitch = s.lineHeight + (s.gaps ? 16 : 8);
+        for (int top = 8; top + s.lineHeight < s.size.height() - 8; top += pitch) {
+            int x = 16 + int(rng.bounded(40));
+            while (true) {
+                const int w = int(rng.bounded(s.wordMin, s.wordMax + 1));
+                if (x + w > s.size.width() - 16) {
+                    break;
+                }
+                const QRect box(x, top, w, s.lineHeight);
+                for (int y = box.top(); y <= box.bottom(); ++y) {
+                    QRgb* line = reinterpret_cast<QRgb*>(page.image.scanLine(y));
+                    for (int px = box.left(); px <= box.right(); ++px) {
+                        // 文字块内部也有明暗，避免整块纯色
+                        const int g = ((px + y) % 5) == 0 ? 160 : 30;
+                        line[px] = qRgb(g, g, g);
+                    }
+                }
+                OcrLine truth;
+                truth.polygon = QPolygon(box, false);
+                truth.text = QStringLiteral("L%1").arg(page.truth.size());
+                truth.confidence = 0.95f;
+                page.truth.push_back(truth);
+                x += w + int(rng.bounded(24, 64));
+            }
+        }
+        return page;
+    }
+
+    // 模拟一片的检测结果：片内可见部分不少于原框 40% 的都报告，坐标换成片内坐标
+    OcrResult DetectInTile(const Page& page, const QRect& tile)
+    {
+        OcrResult result;
+        result.imageSize = tile.size();
+        for (const OcrLine& truth : page.truth) {
+            const QRect box = truth.boundingRect();
+            const QRect visible = box & tile;
+            if (visible.isEmpty() ||
+                qint64(visible.width()) * visible.height() * 10 < qint64(box.width()) * box.height() * 4) {
+                continue;
+            }
+            OcrLine line = truth;
+            line.polygon = QPolygon(visible.translated(-tile.topLeft()), false);
+            result.lines.push_back(line);
+        }
+        return result;
+    }
+
+    struct Check {
+        int missing = 0;
+        int duplicated = 0;
+        int truncated = 0;   // 保留下来的是被切口截断的那个框
+    };
+
+    Check Verify(const Page& page, const OcrResult& merged)
+    {
+        QHash<QString, QVector<QRect>> boxes;
+        for (const OcrLine& line : merged.lines) {
+            boxes[line.text].push_back(line.boundingRect());
+        }
+        Check check;
+        for (const OcrLine& truth : page.truth) {
+            const QVector<QRect> found = boxes.value(truth.text);
+            if (found.isEmpty()) {
+                ++check.missing;
+                continue;
+            }
+            check.duplicated += found.size() - 1;
+            if (found.front() != truth.boundingRect()) {
+                ++check.truncated;
+            }
+        }
+        return check;
+    }
+
+    // 模拟推理：工作量按迭代次数计，而不是忙等到某个时刻。线程数超过核数时
+    // 同样的工作只能排队，超额订阅的代价才会体现在墙钟时间里
+    void Work(quint64 iterations)
+    {
+        volatile quint64 sink = 0;
+        for (quint64 i = 0; i < iterations; ++i) {
+            sink = sink + i;
+        }
+    }
+
+    // 单线程下每微秒的迭代次数，用来把 --engine-us-per-mpx 换成工作量
+    double IterationsPerUs()
+    {
+        QElapsedTimer timer;
+        quint64 iterations = 1u << 20;
+        for (;;) {
+            timer.start();
+            Work(iterations);
+            const qint64 ns = timer.nsecsElapsed();
+            if (ns >= 20 * 1000 * 1000) {
+                return double(iterations) * 1000.0 / double(ns);
+            }
+            iterations *= 2;
+        }
+    }
+
+    // 一个实例识别一片：工作量均分到 engineThreads 个线程上，对应 Paddle 的 cpu_threads
+    void RunEngine(quint64 iterations, int engineThreads)
+    {
+        std::vector<std::thread> helpers;
+        const quint64 share = iterations / quint64(engineThreads);
+        for (int t = 1; t < engineThreads; ++t) {
+            helpers.emplace_back(Work, share);
+        }
+        Work(iterations - share * quint64(engineThreads - 1));
+        for (std::thread& helper : helpers) {
+            helper.join();
+        }
+    }
+
+    // 与 OcrService::recognizeTiled 相同的调度：切片投到 engines 个线程的池里，
+    // 每片用 engineThreads 个推理线程，各片结果按下标放回后合并
+    qint64 RunPipelineUs(const Page& page, int engines, int engineThreads, double iterationsPerMpx,
+        OcrResult* merged)
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(engines);
+        QElapsedTimer timer;
+        timer.start();
+        const QVector<OcrTiler::Tile> tiles = OcrTiler::plan(page.image);
+        QVector<OcrResult> results(tiles.size());
+        for (int i = 0; i < tiles.size(); ++i) {
+            pool.start([&page, &tiles, &results, i, engineThreads, iterationsPerMpx]() {
+                const QRect rect = tiles[i].rect;
+                RunEngine(quint64(iterationsPerMpx * rect.width() * rect.height() / 1e6), engineThreads);
+                results[i] = DetectInTile(page, rect);
+                });
+        }
+        pool.waitForDone();
+        *merged = OcrTiler::merge(tiles, results, page.image.size());
+        return timer.nsecsElapsed() / 1000;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchUtil::UseOffscreenByDefault();
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Plans OCR tiles on synthetic long pages, checks the box-position merge "
+        "against ground truth and times tiled recognition with a simulated multi-threaded engine on 1..N "
+        "engines, with the profile's thread count and with threads divided across the pool.");
+    parser.addHelpOption();
+    QCommandLineOption scenariosOpt("scenarios", "Comma-separated scenarios: tall-gaps, tall-dense, wide.", "list",
+        "tall-gaps,tall-dense,wide");
+    QCommandLineOption threadsOpt("threads", "Comma-separated engine pool sizes for the pipeline run.", "list", "1,2,4");
+    QCommandLineOption costOpt("engine-us-per-mpx",
+        "Simulated single-thread inference cost per megapixel of tile (0 = skip).", "us", "40000");
+    QCommandLineOption profileOpt("profile", "OCR profile whose cpuThreads each engine starts from.", "name",
+        OcrProfile::defaultName());
+    QCommandLineOption runsOpt("runs", "Repetitions for plan / merge timings (median is reported).", "n", "5");
+    QCommandLineOption seedOpt("seed", "Random seed.", "n", "1");
+    parser.addOptions({ scenariosOpt, threadsOpt, costOpt, profileOpt, runsOpt, seedOpt });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList names = parser.value(scenariosOpt).split(',', Qt::SkipEmptyParts);
+    const QVector<int> threads = BenchUtil::ParseInts(parser.value(threadsOpt));
+    const double usPerMpx = qMax(0.0, parser.value(costOpt).toDouble());
+    const int runs = qMax(1, parser.value(runsOpt).toInt());
+    const quint32 seed = parser.value(seedOpt).toUInt();
+    const OcrProfile profile = OcrProfile::byName(parser.value(profileOpt));
+    const double iterationsPerMpx = usPerMpx > 0.0 ? usPerMpx * IterationsPerUs() : 0.0;
+    out << "profile " << profile.name << ": " << profile.cpuThreads << " threads per engine, "
+        << QThread::idealThreadCount() << " cores\n";
+
+    bool allOk = true;
+    for (const QString& name : names) {
+        const Scenario* scenario = nullptr;
+        for (const Scenario& s : kScenarios) {
+            if (name.trimmed() == QLatin1String(s.name)) {
+                scenario = &s;
+            }
+        }
+        if (!scenario) {
+            err << "unknown scenario " << name << '\n';
+            return BenchUtil::kExitUsage;
+        }
+
+        const Page page = MakePage(*scenario, seed);
+        QVector<OcrTiler::Tile> tiles;
+        const qint64 planUs = BenchUtil::MedianUs(runs, [&] { tiles = OcrTiler::plan(page.image); });
+        QVector<OcrResult> results;
+        int overlapped = 0;
+        for (const OcrTiler::Tile& tile : tiles) {
+            results.push_back(DetectInTile(page, tile.rect));
+            overlapped += tile.overlapBefore > 0 ? 1 : 0;
+        }
+        int reported = 0;
+        for (const OcrResult& r : results) {
+            reported += r.lines.size();
+        }
+        OcrResult merged;
+        const qint64 mergeUs = BenchUtil::MedianUs(runs, [&] { merged = OcrTiler::merge(tiles, results, page.image.size()); });
+        const Check check = Verify(page, merged);
+        const bool ok = check.missing == 0 && check.duplicated == 0 && check.truncated == 0;
+        allOk = allOk && ok;
+
+        out << scenario->name << ' ' << page.image.width() << 'x' << page.image.height() << ": "
+            << tiles.size() << " tiles (" << overlapped << " overlapped cuts), plan " << planUs << " us, merge "
+            << mergeUs << " us\n";
+        out << "  lines " << page.truth.size() << ", reported by tiles " << reported << ", merged "
+            << merged.lines.size() << ", missing " << check.missing << ", duplicated " << check.duplicated
+            << ", truncated " << check.truncated << (ok ? "" : "  <-- FAIL") << '\n';
+
+        if (usPerMpx <= 0.0) {
+            continue;
+        }
+        // 单实例整图作对照：同样按面积计工作量，不含切片规划和合并
+        const int wholeThreads = profile.sizedForPool(1).cpuThreads;
+        const qint64 wholeUs = BenchUtil::MedianUs(1, [&] {
+            RunEngine(quint64(iterationsPerMpx * page.image.width() * page.image.height() / 1e6), wholeThreads);
+            });
+        auto row = [&](const QString& engines, const QString& mode, int perEngine, int total, qint64 wallUs) {
+            out << QString("  %1 %2 %3 %4 %5 %6\n")
+                .arg(engines, 7).arg(mode, -9).arg(perEngine, 11).arg(total, 7)
+                .arg(wallUs / 1000.0, 9, 'f', 1)
+                .arg(QString::number(double(wholeUs) / qMax<qint64>(1, wallUs), 'f', 1) + 'x', 8);
+        };
+        out << QString("  %1 %2 %3 %4 %5 %6\n")
+            .arg(QStringLiteral("engines"), 7).arg(QStringLiteral("threads"), -9)
+            .arg(QStringLiteral("per-engine"), 11).arg(QStringLiteral("total"), 7)
+            .arg(QStringLiteral("wall-ms"), 9).arg(QStringLiteral("speedup"), 8);
+        row(QStringLiteral("whole"), QStringLiteral("profile"), wholeThreads, wholeThreads, wholeUs);
+        for (int n : threads) {
+            n = qMax(1, n);
+            // profile：每个实例都按档位原始线程数跑（修正前的行为）；pool：按 OcrService 的做法均分核数
+            const int sized = profile.sizedForPool(n).cpuThreads;
+            for (const bool pooled : { false, true }) {
+                if (pooled && sized == profile.cpuThreads) {
+                    continue;
+                }
+                const int perEngine = pooled ? sized : profile.cpuThreads;
+                OcrResult pipelined;
+                const qint64 wallUs = RunPipelineUs(page, n, perEngine, iterationsPerMpx, &pipelined);
+                if (pipelined.lines.size() != merged.lines.size()) {
+                    allOk = false;
+                    err << scenario->name << ": pipeline with " << n << " engines merged "
+                        << pipelined.lines.size() << " lines\n";
+                }
+                row(QString::number(n), pooled ? QStringLiteral("pool") : QStringLiteral("profile"), perEngine,
+                    n * perEngine, wallUs);
+            }
+        }
+    }
+    return BenchUtil::ReportMatch(out, "merge matches ground truth", allOk);
+}
@@ -0,0 +1,21 @@
+# 大图 OCR 切片基准：只编译 OcrTiler / OcrProfile，推理用按面积计工作量的模拟负载代替，不依赖 Paddle / OpenCV
+TEMPLATE = app
+TARGET = ocr_tiling_bench
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SRC_DIR = $$PWD/../../src
+
+INCLUDEPATH += "$$SRC_DIR/Head Files" $$PWD/../common
+
+HEADERS += \
+    $$PWD/../common/bench_util.h \
+    "$$SRC_DIR/Head Files/OcrProfile.h" \
+    "$$SRC_DIR/Head Files/OcrResult.h" \
+    "$$SRC_DIR/Head Files/OcrTiler.h"
+
+SOURCES += \
+    main.cpp \
+    "$$SRC_DIR/Resources files/OcrProfile.cpp" \
+    "$$SRC_DIR/Resources files/OcrTiler.cpp"